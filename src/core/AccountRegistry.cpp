@@ -0,0 +1,134 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "AccountRegistry.h"
+#include "Database.h"
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <sqlite3.h>
+
+size_t ConsolidatedSummary::GetFailedCount() const {
+    return static_cast<size_t>(std::count_if(mAccounts.begin(), mAccounts.end(),
+                                             [](const AccountSummary& summary) { return !summary.mOk; }));
+}
+
+void AccountRegistry::Load(std::vector<Account> accounts) {
+    mAccounts.clear();
+    for (auto& account : accounts) {
+        Add(account);
+    }
+}
+
+const Account* AccountRegistry::FindByPath(const std::string& path) const {
+    auto it = std::find_if(mAccounts.begin(), mAccounts.end(),
+                           [&path](const Account& account) { return IsSamePath(account.mPath, path); });
+    return it != mAccounts.end() ? &*it : nullptr;
+}
+
+bool AccountRegistry::Add(const Account& account) {
+    if (account.mName.empty() || account.mPath.empty()) {
+        return false;
+    }
+    for (const auto& existing : mAccounts) {
+        if (existing.mName == account.mName || IsSamePath(existing.mPath, account.mPath)) {
+            return false;
+        }
+    }
+    mAccounts.push_back(account);
+    return true;
+}
+
+bool AccountRegistry::Remove(const std::string& path) {
+    auto it = std::find_if(mAccounts.begin(), mAccounts.end(),
+                           [&path](const Account& account) { return IsSamePath(account.mPath, path); });
+    if (it == mAccounts.end()) {
+        return false;
+    }
+    mAccounts.erase(it);
+    return true;
+}
+
+ConsolidatedSummary AccountRegistry::Summarize(int busyTimeoutMs) const {
+    const auto start = std::chrono::steady_clock::now();
+
+    // Un thread par compte : chaque lecture a sa propre connexion
+    std::vector<std::future<AccountSummary>> pending;
+    pending.reserve(mAccounts.size());
+    for (const auto& account : mAccounts) {
+        pending.push_back(std::async(std::launch::async, &AccountRegistry::SummarizeAccount,
+                                     account, busyTimeoutMs));
+    }
+
+    ConsolidatedSummary consolidated;
+    consolidated.mAccounts.reserve(pending.size());
+    for (auto& future : pending) {
+        AccountSummary summary = future.get();
+        if (summary.mOk) {
+            consolidated.mTransactionCount += summary.mTransactionCount;
+            consolidated.mRestant += summary.mRestant;
+            consolidated.mPointee += summary.mPointee;
+        }
+        consolidated.mAccounts.push_back(std::move(summary));
+    }
+    consolidated.mElapsed = std::chrono::steady_clock::now() - start;
+    return consolidated;
+}
+
+AccountSummary AccountRegistry::SummarizeAccount(const Account& account, int busyTimeoutMs) {
+    const auto start = std::chrono::steady_clock::now();
+    AccountSummary summary;
+    summary.mAccount = account;
+
+    sqlite3* db = nullptr;
+    int rc = sqlite3_open_v2(account.mPath.c_str(), &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+    if (rc != SQLITE_OK) {
+        summary.mError = db ? sqlite3_errmsg(db) : sqlite3_errstr(rc);
+        sqlite3_close(db);
+        summary.mElapsed = std::chrono::steady_clock::now() - start;
+        return summary;
+    }
+    sqlite3_busy_timeout(db, busyTimeoutMs);
+
+    // Une seule requête : totaux et nombre de lignes lus sur le même instantané
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql =
+        "SELECT (SELECT user_version FROM pragma_user_version), "
+        "total_restant, total_pointee, (SELECT COUNT(*) FROM transactions) "
+        "FROM balances WHERE id = 1;";
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        summary.mError = sqlite3_errmsg(db);
+    } else if ((rc = sqlite3_step(stmt)) != SQLITE_ROW) {
+        summary.mError = rc == SQLITE_DONE ? "Totaux absents" : sqlite3_errmsg(db);
+    } else if (sqlite3_column_int(stmt, 0) < Database::GetLatestSchemaVersion()) {
+        summary.mError = "Base à mettre à jour : ouvrir le compte une fois";
+    } else {
+        summary.mRestant = Money::FromCents(sqlite3_column_int64(stmt, 1));
+        summary.mPointee = Money::FromCents(sqlite3_column_int64(stmt, 2));
+        summary.mTransactionCount = sqlite3_column_int(stmt, 3);
+        summary.mOk = true;
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+
+    if (!summary.mOk) {
+        std::cerr << "Erreur lecture du compte " << account.mName << ": " << summary.mError << std::endl;
+    }
+    summary.mElapsed = std::chrono::steady_clock::now() - start;
+    return summary;
+}
+
+bool AccountRegistry::IsSamePath(const std::string& a, const std::string& b) {
+    std::error_code ec;
+    if (std::filesystem::equivalent(a, b, ec)) {
+        return true;
+    }
+    // Fichiers pas encore créés : comparaison des chemins absolus
+    auto normalize = [](const std::string& path) {
+        std::error_code error;
+        return std::filesystem::absolute(path, error).lexically_normal();
+    };
+    return normalize(a) == normalize(b);
+}
@@ -0,0 +1,69 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef ACCOUNTREGISTRY_H
+#define ACCOUNTREGISTRY_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Money.h"
+
+// Compte : un fichier de base MesComptes et le nom affiché
+struct Account {
+    std::string mName;
+    std::string mPath;
+};
+
+// Totaux d'un compte, lus depuis sa table balances
+struct AccountSummary {
+    Account mAccount;
+    bool mOk = false;
+    std::string mError;
+    int mTransactionCount = 0;
+    Money mRestant;
+    Money mPointee;
+    std::chrono::nanoseconds mElapsed{0};
+};
+
+// Synthèse de plusieurs comptes ; les totaux ne comptent que les comptes lus
+struct ConsolidatedSummary {
+    std::vector<AccountSummary> mAccounts;  // Dans l'ordre du registre
+    int mTransactionCount = 0;
+    Money mRestant;
+    Money mPointee;
+    std::chrono::nanoseconds mElapsed{0};
+
+    size_t GetFailedCount() const;
+};
+
+// Liste des comptes connus. Chaque compte garde son propre fichier : la
+// synthèse ouvre une connexion en lecture seule par compte, chacune sur son
+// propre thread, puis additionne les résultats. Un ATTACH de tous les
+// fichiers sur une seule connexion lirait les comptes l'un après l'autre.
+class AccountRegistry {
+public:
+    void Load(std::vector<Account> accounts);
+    const std::vector<Account>& GetAccounts() const { return mAccounts; }
+    bool IsEmpty() const { return mAccounts.empty(); }
+
+    // nullptr si aucun compte n'utilise ce fichier
+    const Account* FindByPath(const std::string& path) const;
+    // Refuse un nom vide ou un nom ou un fichier déjà enregistré
+    bool Add(const Account& account);
+    bool Remove(const std::string& path);
+
+    // Lit tous les comptes en parallèle ; le temps total est celui du plus lent
+    ConsolidatedSummary Summarize(int busyTimeoutMs = 5000) const;
+    // Lit un compte sur une connexion en lecture seule. La base doit être à
+    // jour (ouverte au moins une fois par Database) pour que balances existe.
+    static AccountSummary SummarizeAccount(const Account& account, int busyTimeoutMs = 5000);
+
+    static bool IsSamePath(const std::string& a, const std::string& b);
+
+private:
+    std::vector<Account> mAccounts;
+};
+
+#endif // ACCOUNTREGISTRY_H
@@ -0,0 +1,95 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "AsyncDatabase.h"
+#include <iostream>
+
+void DetachedTask::promise_type::unhandled_exception() noexcept {
+    AsyncDatabase::ReportException("Tâche interrompue", std::current_exception());
+}
+
+AsyncDatabase::AsyncDatabase(std::unique_ptr<Database> database, Dispatcher dispatcher)
+    : mDatabase(std::move(database)), mDispatcher(std::move(dispatcher)) {
+    mWriter.mThread = std::thread([this]() {
+        Drain(mWriter, [this](Job& job) { job(*mDatabase); });
+    });
+    mReporter.mThread = std::thread([this]() {
+        Drain(mReporter, [](std::function<void()>& report) { report(); });
+    });
+}
+
+AsyncDatabase::~AsyncDatabase() {
+    // Les requêtes en file peuvent encore envoyer des rapports :
+    // le thread de la base s'arrête d'abord, celui des rapports ensuite
+    Push(mWriter, Job());
+    mWriter.mThread.join();
+    Push(mReporter, std::function<void()>());
+    mReporter.mThread.join();
+
+    // Plus aucun thread n'utilise la base
+    mDatabase->Close();
+}
+
+void AsyncDatabase::Post(Job job) {
+    Push(mWriter, std::move(job));
+}
+
+void AsyncDatabase::PostReport(ReportJob report) {
+    Post([this, report = std::move(report)](Database& db) mutable {
+        db.FlushPendingWrites();
+
+        // Sans pool, l'instantané est sur la connexion d'écriture : lu ici même
+        if (!db.HasReaderPool()) {
+            ReadSnapshot snapshot = db.OpenSnapshot();
+            report(snapshot);
+            return;
+        }
+        // Connexion empruntée par le thread des rapports : si le pool est
+        // occupé, c'est lui qui attend, jamais le thread de la base
+        Push(mReporter, std::function<void()>([&db, report = std::move(report)]() mutable {
+            ReadSnapshot snapshot = db.OpenReaderSnapshot();
+            report(snapshot);
+        }));
+    });
+}
+
+template <typename T>
+void AsyncDatabase::Push(Worker<T>& worker, T job) {
+    worker.mJobs.Push(std::move(job));
+    worker.mPendingJobs.release();
+}
+
+template <typename T, typename Run>
+void AsyncDatabase::Drain(Worker<T>& worker, Run run) {
+    while (true) {
+        worker.mPendingJobs.acquire();
+
+        // L'élément est compté mais son producteur peut ne pas avoir fini de le chaîner
+        std::optional<T> job;
+        while (!(job = worker.mJobs.Pop())) {
+            std::this_thread::yield();
+        }
+
+        if (!*job) {
+            break;
+        }
+
+        // Une requête en échec ne doit pas arrêter le thread ni la file
+        try {
+            run(*job);
+        } catch (...) {
+            ReportException("Requête en échec", std::current_exception());
+        }
+    }
+}
+
+void AsyncDatabase::ReportException(std::string_view context, std::exception_ptr error) noexcept {
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        std::cerr << context << " : " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << context << " : exception inconnue" << std::endl;
+    }
+}
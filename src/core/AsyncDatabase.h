@@ -0,0 +1,214 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef ASYNCDATABASE_H
+#define ASYNCDATABASE_H
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <semaphore>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "Database.h"
+#include "MpscQueue.h"
+
+// Coroutine lancée immédiatement et jamais attendue (ex. rechargement de
+// l'interface) : elle reprend sur le thread de l'interface après chaque co_await.
+// Une exception non rattrapée (requête en échec comprise) termine la coroutine
+// et est signalée sur std::cerr.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept;
+    };
+};
+
+// Façade asynchrone de Database : un thread dédié est le seul à utiliser la
+// connexion SQLite. Les requêtes passent par une file sans verrou et sont
+// exécutées dans l'ordre d'envoi ; les résultats reviennent par std::future,
+// par un rappel ou par co_await, sur le thread de l'interface via le Dispatcher.
+// Les rapports (exports, sauvegarde) s'exécutent sur un second thread, sur un
+// instantané du pool de lecture, sans bloquer les modifications.
+class AsyncDatabase {
+public:
+    using Job = std::function<void(Database&)>;
+    using ReportJob = std::function<void(ReadSnapshot&)>;
+    // Exécute une fonction sur le thread de l'interface (wxEvtHandler::CallAfter)
+    using Dispatcher = std::function<void(std::function<void()>)>;
+
+    AsyncDatabase(std::unique_ptr<Database> database, Dispatcher dispatcher);
+    // Termine les requêtes et rapports en file puis ferme la base
+    ~AsyncDatabase();
+
+    AsyncDatabase(const AsyncDatabase&) = delete;
+    AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+
+    // Résultat disponible par std::future
+    template <typename F>
+    auto Submit(F job) -> std::future<std::invoke_result_t<F&, Database&>> {
+        using Result = std::invoke_result_t<F&, Database&>;
+        auto task = std::make_shared<std::packaged_task<Result(Database&)>>(std::move(job));
+        auto future = task->get_future();
+        Post([task](Database& db) { (*task)(db); });
+        return future;
+    }
+
+    // Résultat remis à onDone sur le thread de l'interface ; une requête qui
+    // lève une exception est signalée sur std::cerr et onDone n'est pas appelé
+    template <typename F, typename Done>
+    void Submit(F job, Done onDone) {
+        static_assert(!std::is_void_v<std::invoke_result_t<F&, Database&>>,
+                      "La requête doit retourner une valeur");
+        Post([this, job = std::move(job), onDone = std::move(onDone)](Database& db) mutable {
+            auto result = job(db);
+            mDispatcher([onDone = std::move(onDone), result = std::move(result)]() mutable {
+                onDone(std::move(result));
+            });
+        });
+    }
+
+    // Appel synchrone, pour les opérations courtes de l'interface :
+    // Call(&Database::DeleteTransaction, id) ou Call([](Database& db) { ... }).
+    // Attend la fin des requêtes déjà en file.
+    template <typename F, typename... Args>
+    auto Call(F&& function, Args&&... args) -> std::invoke_result_t<F, Database&, Args...> {
+        auto job = [&](Database& db) {
+            return std::invoke(std::forward<F>(function), db, std::forward<Args>(args)...);
+        };
+        if (IsWorkerThread()) {
+            return job(*mDatabase);
+        }
+        return Submit(job).get();
+    }
+
+    // Rapport synchrone sur un instantané pris après les requêtes déjà en file
+    // (pointages en attente compris). Le rapport ne doit pas appeler Call.
+    template <typename F>
+    auto CallReport(F&& report) -> std::invoke_result_t<F&, ReadSnapshot&> {
+        using Result = std::invoke_result_t<F&, ReadSnapshot&>;
+        if (IsWorkerThread()) {
+            mDatabase->FlushPendingWrites();
+            ReadSnapshot snapshot = mDatabase->OpenSnapshot();
+            return report(snapshot);
+        }
+        auto task = std::make_shared<std::packaged_task<Result(ReadSnapshot&)>>(std::ref(report));
+        auto future = task->get_future();
+        PostReport([task](ReadSnapshot& snapshot) { (*task)(snapshot); });
+        return future.get();
+    }
+
+    // co_await Async(job) dans une DetachedTask : suspend la coroutine pendant
+    // la requête et la reprend sur le thread de l'interface avec le résultat.
+    // Une requête qui capture des objets doit être nommée avant le co_await :
+    // GCC 12 déplace mal une lambda temporaire dans la trame de la coroutine.
+    // co_await AsyncReport(report) : même principe, le rapport reçoit un ReadSnapshot.
+    template <typename F, typename Source = Database>
+    class Awaiter {
+    public:
+        using Result = std::invoke_result_t<F&, Source&>;
+        static_assert(!std::is_void_v<Result>, "La requête doit retourner une valeur");
+
+        Awaiter(AsyncDatabase& owner, F job)
+            : mOwner(owner), mState(std::make_shared<State>(std::move(job))) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            auto run = [state = mState, dispatcher = &mOwner.mDispatcher, handle](Source& source) {
+                // La coroutine reprend dans tous les cas ; l'exception est
+                // relancée par await_resume, sur le thread de l'interface
+                try {
+                    state->mResult.emplace(state->mJob(source));
+                } catch (...) {
+                    state->mError = std::current_exception();
+                }
+                (*dispatcher)([handle]() { handle.resume(); });
+            };
+            if constexpr (std::is_same_v<Source, ReadSnapshot>) {
+                mOwner.PostReport(std::move(run));
+            } else {
+                mOwner.Post(std::move(run));
+            }
+        }
+
+        Result await_resume() {
+            if (mState->mError) {
+                std::rethrow_exception(mState->mError);
+            }
+            return std::move(*mState->mResult);
+        }
+
+    private:
+        // Requête et résultat hors de la trame de la coroutine : le thread de
+        // la base n'y garde aucune adresse qui pourrait être déplacée
+        struct State {
+            explicit State(F job) : mJob(std::move(job)) {}
+            F mJob;
+            std::optional<Result> mResult;
+            std::exception_ptr mError;
+        };
+
+        AsyncDatabase& mOwner;
+        std::shared_ptr<State> mState;
+    };
+
+    template <typename F>
+    Awaiter<F> Async(F job) {
+        return Awaiter<F>(*this, std::move(job));
+    }
+
+    template <typename F>
+    Awaiter<F, ReadSnapshot> AsyncReport(F report) {
+        return Awaiter<F, ReadSnapshot>(*this, std::move(report));
+    }
+
+    // Types en mémoire, lus depuis l'interface sans passer par la file.
+    // Ils ne sont modifiés que par AddType/UpdateType/RenameType/DeleteType/ReloadTypes
+    // via Call, pendant que l'interface attend.
+    const TypeRegistry& GetTypeRegistry() const { return mDatabase->GetTypeRegistry(); }
+    bool IsTypeDepense(std::string_view type) const { return mDatabase->IsTypeDepense(type); }
+    bool IsTypeDepense(int typeId) const { return mDatabase->IsTypeDepense(typeId); }
+
+    bool IsWorkerThread() const { return std::this_thread::get_id() == mWriter.mThread.get_id(); }
+
+    // Message d'une exception sur std::cerr, précédé du contexte
+    static void ReportException(std::string_view context, std::exception_ptr error) noexcept;
+
+private:
+    // File et thread d'exécution ; une tâche vide marque la fin de la file
+    template <typename T>
+    struct Worker {
+        MpscQueue<T> mJobs;
+        std::counting_semaphore<> mPendingJobs{0};
+        std::thread mThread;
+    };
+
+    void Post(Job job);
+    // Les écritures en file avant le rapport sont validées sur le thread de la
+    // base (pointages en attente compris), puis l'instantané est ouvert et lu
+    // sur le thread des rapports : il les voit toutes, et peut aussi voir des
+    // écritures envoyées après le rapport
+    void PostReport(ReportJob report);
+
+    template <typename T>
+    static void Push(Worker<T>& worker, T job);
+    template <typename T, typename Run>
+    static void Drain(Worker<T>& worker, Run run);
+
+    std::unique_ptr<Database> mDatabase;
+    Dispatcher mDispatcher;
+    Worker<Job> mWriter;
+    Worker<std::function<void()>> mReporter;
+};
+
+#endif // ASYNCDATABASE_H
@@ -0,0 +1,94 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "ChangeLog.h"
+#include <algorithm>
+#include <map>
+
+void ChangeLog::Record(ChangeKind kind, int64_t rowId) {
+    mUncommitted.push_back({0, rowId, kind});
+}
+
+void ChangeLog::RecordUnknown() {
+    mUncommittedUnknown = true;
+}
+
+void ChangeLog::Commit() {
+    if (mUncommittedUnknown) {
+        mUncommittedUnknown = false;
+        mUncommitted.clear();
+        Invalidate();
+        return;
+    }
+    if (mUncommitted.empty()) {
+        return;
+    }
+
+    ++mVersion;
+    for (Entry& entry : mUncommitted) {
+        entry.mVersion = mVersion;
+        mEntries.push_back(entry);
+    }
+    mUncommitted.clear();
+
+    while (mEntries.size() > kMaxEntries) {
+        mHorizon = std::max(mHorizon, mEntries.front().mVersion);
+        mEntries.pop_front();
+    }
+}
+
+void ChangeLog::Rollback() {
+    mUncommitted.clear();
+    mUncommittedUnknown = false;
+}
+
+void ChangeLog::Invalidate() {
+    ++mVersion;
+    mHorizon = mVersion;
+    mEntries.clear();
+}
+
+ChangeSet ChangeLog::GetChangesSince(uint64_t version) const {
+    ChangeSet changes;
+    changes.mVersion = mVersion;
+    if (version < mHorizon) {
+        changes.mFullReload = true;
+        return changes;
+    }
+
+    // Première et dernière opération de chaque ligne depuis la version
+    std::map<int64_t, std::pair<ChangeKind, ChangeKind>> rows;
+    auto first = std::upper_bound(mEntries.begin(), mEntries.end(), version,
+                                  [](uint64_t v, const Entry& entry) { return v < entry.mVersion; });
+    for (auto it = first; it != mEntries.end(); ++it) {
+        auto [row, inserted] = rows.try_emplace(it->mRowId, it->mKind, it->mKind);
+        if (!inserted) {
+            row->second.second = it->mKind;
+        }
+    }
+
+    for (const auto& [rowId, kinds] : rows) {
+        const int id = static_cast<int>(rowId);
+        const auto [firstKind, lastKind] = kinds;
+        if (lastKind == ChangeKind::DELETED) {
+            // Insérée puis supprimée : jamais vue par l'appelant
+            if (firstKind != ChangeKind::INSERTED) {
+                changes.mDeleted.push_back(id);
+            }
+        } else if (firstKind == ChangeKind::INSERTED) {
+            changes.mInserted.push_back(id);
+        } else {
+            // Modifiée, ou supprimée puis id réutilisé
+            changes.mUpdated.push_back(id);
+        }
+    }
+    return changes;
+}
+
+void ChangeLog::Clear() {
+    // La version reste croissante : un appelant qui garde une ancienne
+    // version relira tout après une réouverture
+    Rollback();
+    Invalidate();
+}
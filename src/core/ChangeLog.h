@@ -0,0 +1,66 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef CHANGELOG_H
+#define CHANGELOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+enum class ChangeKind {
+    INSERTED,
+    UPDATED,
+    DELETED
+};
+
+// Transactions modifiées depuis une version donnée. Les ids sont nets :
+// une ligne insérée puis supprimée entre-temps n'apparaît pas.
+struct ChangeSet {
+    uint64_t mVersion = 0;     // Version courante, à passer à l'appel suivant
+    bool mFullReload = false;  // Historique insuffisant ou modification externe : tout relire
+    std::vector<int> mInserted;
+    std::vector<int> mUpdated;
+    std::vector<int> mDeleted;
+
+    size_t GetCount() const { return mInserted.size() + mUpdated.size() + mDeleted.size(); }
+    bool IsEmpty() const { return !mFullReload && GetCount() == 0; }
+};
+
+// Journal des lignes modifiées, alimenté par les hooks SQLite de Database.
+// Les changements d'une transaction SQL ne sont publiés qu'à sa validation,
+// chaque validation donnant une nouvelle version.
+class ChangeLog {
+public:
+    void Record(ChangeKind kind, int64_t rowId);
+    // Modification dont les lignes ne sont pas connues (types, autre processus)
+    void RecordUnknown();
+    void Commit();
+    void Rollback();
+    // Modification faite hors de la connexion : nouvelle version, relecture complète
+    void Invalidate();
+
+    uint64_t GetVersion() const { return mVersion; }
+    ChangeSet GetChangesSince(uint64_t version) const;
+    void Clear();
+
+private:
+    struct Entry {
+        uint64_t mVersion;
+        int64_t mRowId;
+        ChangeKind mKind;
+    };
+
+    // Au-delà, les entrées les plus anciennes sont oubliées
+    static constexpr size_t kMaxEntries = 10000;
+
+    std::vector<Entry> mUncommitted;
+    bool mUncommittedUnknown = false;
+    std::deque<Entry> mEntries;
+    uint64_t mVersion = 0;
+    uint64_t mHorizon = 0;  // Les demandes antérieures imposent une relecture complète
+};
+
+#endif // CHANGELOG_H
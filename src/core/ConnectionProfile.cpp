@@ -0,0 +1,85 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "ConnectionProfile.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+ConnectionProfile ConnectionProfile::Interactive() {
+    return ConnectionProfile();
+}
+
+ConnectionProfile ConnectionProfile::BulkLoad(const ConnectionProfile& base) {
+    ConnectionProfile profile = base;
+    // Le mode de journal n'est pas modifié : quitter WAL exige un accès exclusif
+    profile.mSynchronous = SYNC_OFF;
+    profile.mCacheSize = std::min(base.mCacheSize, -65536);  // Au moins 64 Mo
+    profile.mTempStore = TEMP_STORE_MEMORY;
+    return profile;
+}
+
+std::vector<std::string> ConnectionProfile::ToPragmas() const {
+    std::vector<std::string> pragmas;
+    pragmas.push_back(std::string("PRAGMA journal_mode=") + GetJournalModeName(mJournalMode) + ";");
+    pragmas.push_back(std::string("PRAGMA synchronous=") + GetSynchronousName(mSynchronous) + ";");
+    pragmas.push_back("PRAGMA mmap_size=" + std::to_string(mMmapSize) + ";");
+    pragmas.push_back("PRAGMA cache_size=" + std::to_string(mCacheSize) + ";");
+    pragmas.push_back(std::string("PRAGMA temp_store=") + GetTempStoreName(mTempStore) + ";");
+    return pragmas;
+}
+
+std::string ConnectionProfile::ToString() const {
+    std::ostringstream out;
+    out << "journal_mode=" << GetJournalModeName(mJournalMode)
+        << ", synchronous=" << GetSynchronousName(mSynchronous)
+        << ", mmap_size=" << mMmapSize
+        << ", cache_size=" << mCacheSize
+        << ", temp_store=" << GetTempStoreName(mTempStore)
+        << ", busy_timeout=" << mBusyTimeoutMs << " ms";
+    return out.str();
+}
+
+const char* ConnectionProfile::GetJournalModeName(JournalMode mode) {
+    switch (mode) {
+        case JOURNAL_DELETE: return "DELETE";
+        case JOURNAL_TRUNCATE: return "TRUNCATE";
+        case JOURNAL_PERSIST: return "PERSIST";
+        case JOURNAL_MEMORY: return "MEMORY";
+        case JOURNAL_WAL: return "WAL";
+        case JOURNAL_OFF: return "OFF";
+        default: return "DELETE";
+    }
+}
+
+const char* ConnectionProfile::GetSynchronousName(SynchronousLevel level) {
+    switch (level) {
+        case SYNC_OFF: return "OFF";
+        case SYNC_NORMAL: return "NORMAL";
+        case SYNC_FULL: return "FULL";
+        case SYNC_EXTRA: return "EXTRA";
+        default: return "FULL";
+    }
+}
+
+const char* ConnectionProfile::GetTempStoreName(TempStore store) {
+    switch (store) {
+        case TEMP_STORE_DEFAULT: return "DEFAULT";
+        case TEMP_STORE_FILE: return "FILE";
+        case TEMP_STORE_MEMORY: return "MEMORY";
+        default: return "DEFAULT";
+    }
+}
+
+ConnectionProfile::JournalMode ConnectionProfile::ParseJournalMode(const std::string& name) {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    for (int mode = JOURNAL_DELETE; mode <= JOURNAL_OFF; ++mode) {
+        if (upper == GetJournalModeName(static_cast<JournalMode>(mode))) {
+            return static_cast<JournalMode>(mode);
+        }
+    }
+    return JOURNAL_DELETE;
+}
@@ -0,0 +1,63 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef CONNECTIONPROFILE_H
+#define CONNECTIONPROFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Réglages SQLite appliqués à l'ouverture de la connexion
+struct ConnectionProfile {
+    enum JournalMode {
+        JOURNAL_DELETE,
+        JOURNAL_TRUNCATE,
+        JOURNAL_PERSIST,
+        JOURNAL_MEMORY,
+        JOURNAL_WAL,
+        JOURNAL_OFF
+    };
+
+    // Mêmes valeurs que PRAGMA synchronous
+    enum SynchronousLevel {
+        SYNC_OFF,
+        SYNC_NORMAL,
+        SYNC_FULL,
+        SYNC_EXTRA
+    };
+
+    // Mêmes valeurs que PRAGMA temp_store
+    enum TempStore {
+        TEMP_STORE_DEFAULT,
+        TEMP_STORE_FILE,
+        TEMP_STORE_MEMORY
+    };
+
+    JournalMode mJournalMode = JOURNAL_WAL;
+    SynchronousLevel mSynchronous = SYNC_NORMAL;
+    int64_t mMmapSize = 256LL * 1024 * 1024;  // Octets, 0 = désactivé
+    int mCacheSize = -16384;                   // Négatif = Kio (16 Mo), positif = pages
+    TempStore mTempStore = TEMP_STORE_MEMORY;
+    int mBusyTimeoutMs = 5000;
+
+    // Profil utilisé au quotidien : WAL + synchronous=NORMAL
+    static ConnectionProfile Interactive();
+
+    // Profil temporaire pour les insertions massives (importation, rattrapage
+    // des récurrences) : durabilité réduite, cache plus grand
+    static ConnectionProfile BulkLoad(const ConnectionProfile& base);
+
+    // Requêtes PRAGMA correspondant au profil
+    std::vector<std::string> ToPragmas() const;
+
+    std::string ToString() const;
+
+    static const char* GetJournalModeName(JournalMode mode);
+    static const char* GetSynchronousName(SynchronousLevel level);
+    static const char* GetTempStoreName(TempStore store);
+    static JournalMode ParseJournalMode(const std::string& name);
+};
+
+#endif // CONNECTIONPROFILE_H
@@ -3,11 +3,22 @@
 //
 
 #include <core/Database.h>
+#include <core/DayNumber.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <sstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <utility>
 
-Database::Database(const std::string& dbPath)
-    : mDbPath(dbPath), mDb(nullptr) {}
+Database::Database(const std::string& dbPath, const ConnectionProfile& profile)
+    : mDbPath(dbPath), mDb(nullptr), mProfile(profile), mActiveProfile(profile) {}
 
 Database::~Database() {
     Close();
@@ -19,33 +30,138 @@ bool Database::Open() {
         std::cerr << "Erreur lors de l'ouverture de la base: " << sqlite3_errmsg(mDb) << std::endl;
         return false;
     }
+    mProfiler.Attach(mDb);
 
-    if (!CreateTables()) {
+    if (!ApplyPragmas(mProfile, true)) {
+        std::cerr << "Profil de connexion partiellement appliqué" << std::endl;
+    }
+
+    // Les transactions référencent leur type par clé étrangère ; SQLite ne
+    // la vérifie que si on le demande à chaque connexion
+    sqlite3_exec(mDb, "PRAGMA foreign_keys = ON;", nullptr, nullptr, nullptr);
+
+    if (!MigrateSchema()) {
         return false;
     }
 
-    MigrateTypesTable();
-    InitializeDefaultTypes();
+    if (!mStatements.Prepare(mDb)) {
+        return false;
+    }
+
+    mTypes.Load(GetAllTypes());
+    if (!InitializeBalances()) {
+        return false;
+    }
+
+    // Le schéma est prêt : seules les modifications suivantes sont suivies
+    InstallChangeHooks();
+
+    // Les lecteurs ne travaillent en parallèle de l'écriture qu'en mode WAL
+    if (mActiveProfile.mJournalMode == ConnectionProfile::JOURNAL_WAL &&
+        !mReaders.Open(mDbPath, mActiveProfile, kReaderPoolSize, &mProfiler)) {
+        std::cerr << "Connexions de lecture indisponibles, lectures sur la connexion principale" << std::endl;
+    }
     return true;
 }
 
 void Database::Close() {
     if (mDb) {
+        // Dernière chance d'écrire les pointages en attente
+        FlushPendingWrites();
+        mReaders.Close();
+        sqlite3_update_hook(mDb, nullptr, nullptr);
+        sqlite3_commit_hook(mDb, nullptr, nullptr);
+        sqlite3_rollback_hook(mDb, nullptr, nullptr);
+        mChanges.Clear();
+        mDataVersion = -1;
+        mStatements.Finalize();
+        mTypes.Clear();
+        // Met à jour les statistiques utilisées par le planificateur si nécessaire
+        sqlite3_exec(mDb, "PRAGMA optimize;", nullptr, nullptr, nullptr);
+        mProfiler.Detach(mDb);
         sqlite3_close(mDb);
         mDb = nullptr;
     }
 }
 
+bool Database::ApplyProfile(const ConnectionProfile& profile) {
+    if (!mDb) {
+        return false;
+    }
+
+    // Changer de mode de journal est coûteux et impossible dans une transaction ouverte
+    const bool changeJournal = profile.mJournalMode != mActiveProfile.mJournalMode &&
+                               sqlite3_get_autocommit(mDb) != 0;
+    return ApplyPragmas(profile, changeJournal);
+}
+
+bool Database::ApplyPragmas(const ConnectionProfile& profile, bool includeJournalMode) {
+    bool success = sqlite3_busy_timeout(mDb, profile.mBusyTimeoutMs) == SQLITE_OK;
+
+    for (const auto& pragma : profile.ToPragmas()) {
+        if (!includeJournalMode && pragma.rfind("PRAGMA journal_mode", 0) == 0) {
+            continue;
+        }
+
+        char* errMsg = nullptr;
+        if (sqlite3_exec(mDb, pragma.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::cerr << "Erreur " << pragma << ": " << (errMsg ? errMsg : "") << std::endl;
+            sqlite3_free(errMsg);
+            success = false;
+        }
+    }
+
+    const ConnectionProfile::JournalMode previousJournal = mActiveProfile.mJournalMode;
+    mActiveProfile = profile;
+    if (!includeJournalMode) {
+        mActiveProfile.mJournalMode = previousJournal;
+    }
+    return success;
+}
+
+void Database::Checkpoint() {
+    if (mDb && mActiveProfile.mJournalMode == ConnectionProfile::JOURNAL_WAL) {
+        sqlite3_wal_checkpoint_v2(mDb, nullptr, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
+    }
+}
+
+std::string Database::QueryPragma(const char* pragma) {
+    std::string sql = std::string("PRAGMA ") + pragma + ";";
+    std::string value;
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_text(stmt, 0)) {
+            value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+    }
+    return value;
+}
+
+std::string Database::GetConnectionInfo() {
+    std::ostringstream info;
+    info << "Profil configuré : " << mProfile.ToString() << "\n";
+    if (mDb) {
+        info << "Valeurs effectives : journal_mode=" << QueryPragma("journal_mode")
+             << ", synchronous=" << QueryPragma("synchronous")
+             << ", mmap_size=" << QueryPragma("mmap_size")
+             << ", cache_size=" << QueryPragma("cache_size")
+             << ", temp_store=" << QueryPragma("temp_store") << "\n";
+    }
+    return info.str();
+}
+
 bool Database::CreateTables() {
     const char* createTransactionsTable = R"(
         CREATE TABLE IF NOT EXISTS transactions (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
-            date TEXT NOT NULL,
+            date INTEGER NOT NULL,
             libelle TEXT NOT NULL,
-            somme REAL NOT NULL,
+            somme INTEGER NOT NULL,
             pointee INTEGER DEFAULT 0,
             type TEXT NOT NULL,
-            date_pointee TEXT
+            date_pointee INTEGER
         );
     )";
 
@@ -61,17 +177,26 @@ bool Database::CreateTables() {
         CREATE TABLE IF NOT EXISTS recurring_transactions (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             libelle TEXT NOT NULL,
-            somme REAL NOT NULL,
+            somme INTEGER NOT NULL,
             type TEXT NOT NULL,
             recurrence_type INTEGER NOT NULL,
-            start_date TEXT NOT NULL,
-            end_date TEXT,
-            last_executed TEXT,
+            start_date INTEGER NOT NULL,
+            end_date INTEGER,
+            last_executed INTEGER,
             day_of_month INTEGER DEFAULT 1,
             active INTEGER DEFAULT 1
         );
     )";
 
+    // Totaux en centimes maintenus par triggers (une seule ligne, id = 1)
+    const char* createBalancesTable = R"(
+        CREATE TABLE IF NOT EXISTS balances (
+            id INTEGER PRIMARY KEY CHECK (id = 1),
+            total_restant INTEGER NOT NULL DEFAULT 0,
+            total_pointee INTEGER NOT NULL DEFAULT 0
+        );
+    )";
+
     char* errMsg = nullptr;
     
     if (sqlite3_exec(mDb, createTransactionsTable, nullptr, nullptr, &errMsg) != SQLITE_OK) {
@@ -92,9 +217,220 @@ bool Database::CreateTables() {
         return false;
     }
 
+    if (sqlite3_exec(mDb, createBalancesTable, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur création table balances: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    return true;
+}
+
+namespace {
+
+struct IndexDef {
+    const char* mName;
+    const char* mSql;
+};
+
+// Index secondaires gérés par le schéma
+const IndexDef kIndexDefs[] = {
+    // Tri de la liste principale (ORDER BY date)
+    {"idx_transactions_date",
+     "CREATE INDEX IF NOT EXISTS idx_transactions_date ON transactions(date, id);"},
+    // Index couvrant des totaux : filtre sur pointee, jointure sur type, somme lue dans l'index
+    {"idx_transactions_totals",
+     "CREATE INDEX IF NOT EXISTS idx_transactions_totals ON transactions(pointee, type, somme);"},
+    // Jointure et recherche par type (IsTypeUsed)
+    {"idx_transactions_type",
+     "CREATE INDEX IF NOT EXISTS idx_transactions_type ON transactions(type);"},
+    // Liste des transactions récurrentes (ORDER BY start_date)
+    {"idx_recurring_start_date",
+     "CREATE INDEX IF NOT EXISTS idx_recurring_start_date ON recurring_transactions(start_date);"},
+};
+
+} // namespace
+
+bool Database::CreateIndexes() {
+    for (const auto& index : kIndexDefs) {
+        char* errMsg = nullptr;
+        if (sqlite3_exec(mDb, index.mSql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::cerr << "Erreur création index " << index.mName << ": " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Database::CreateBalanceTriggers() {
+    // Montant signé d'une ligne : négatif pour une dépense, nul si le type
+    // n'existe pas (comme la jointure des totaux)
+    const char* createTriggers = R"(
+        CREATE TRIGGER IF NOT EXISTS trg_balances_transaction_insert
+        AFTER INSERT ON transactions
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant + COALESCE(
+                    (SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                     FROM types WHERE nom = NEW.type), 0),
+                total_pointee = total_pointee + CASE WHEN NEW.pointee = 1 THEN COALESCE(
+                    (SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                     FROM types WHERE nom = NEW.type), 0) ELSE 0 END
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_balances_transaction_delete
+        AFTER DELETE ON transactions
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant - COALESCE(
+                    (SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                     FROM types WHERE nom = OLD.type), 0),
+                total_pointee = total_pointee - CASE WHEN OLD.pointee = 1 THEN COALESCE(
+                    (SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                     FROM types WHERE nom = OLD.type), 0) ELSE 0 END
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_balances_transaction_update
+        AFTER UPDATE OF somme, pointee, type ON transactions
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant
+                    + COALESCE((SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                                FROM types WHERE nom = NEW.type), 0)
+                    - COALESCE((SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                                FROM types WHERE nom = OLD.type), 0),
+                total_pointee = total_pointee
+                    + CASE WHEN NEW.pointee = 1 THEN COALESCE(
+                        (SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                         FROM types WHERE nom = NEW.type), 0) ELSE 0 END
+                    - CASE WHEN OLD.pointee = 1 THEN COALESCE(
+                        (SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                         FROM types WHERE nom = OLD.type), 0) ELSE 0 END
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_balances_type_insert
+        AFTER INSERT ON types
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant + (CASE WHEN NEW.is_depense = 1 THEN -1 ELSE 1 END) *
+                    (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = NEW.nom),
+                total_pointee = total_pointee + (CASE WHEN NEW.is_depense = 1 THEN -1 ELSE 1 END) *
+                    (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = NEW.nom AND pointee = 1)
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_balances_type_delete
+        AFTER DELETE ON types
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant - (CASE WHEN OLD.is_depense = 1 THEN -1 ELSE 1 END) *
+                    (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = OLD.nom),
+                total_pointee = total_pointee - (CASE WHEN OLD.is_depense = 1 THEN -1 ELSE 1 END) *
+                    (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = OLD.nom AND pointee = 1)
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_balances_type_update
+        AFTER UPDATE OF nom, is_depense ON types
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant
+                    + (CASE WHEN NEW.is_depense = 1 THEN -1 ELSE 1 END) *
+                      (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = NEW.nom)
+                    - (CASE WHEN OLD.is_depense = 1 THEN -1 ELSE 1 END) *
+                      (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = OLD.nom),
+                total_pointee = total_pointee
+                    + (CASE WHEN NEW.is_depense = 1 THEN -1 ELSE 1 END) *
+                      (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = NEW.nom AND pointee = 1)
+                    - (CASE WHEN OLD.is_depense = 1 THEN -1 ELSE 1 END) *
+                      (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type = OLD.nom AND pointee = 1)
+            WHERE id = 1;
+        END;
+    )";
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, createTriggers, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur création triggers balances: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool Database::CreateSearchIndex() {
+    // Index externe : le texte reste dans transactions, l'index ne garde que
+    // les trigrammes. Les triggers le tiennent à jour.
+    const char* createIndex = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS transactions_fts USING fts5(
+            libelle, content = 'transactions', content_rowid = 'id', tokenize = 'trigram'
+        );
+
+        CREATE TRIGGER IF NOT EXISTS trg_fts_transaction_insert
+        AFTER INSERT ON transactions
+        BEGIN
+            INSERT INTO transactions_fts(rowid, libelle) VALUES (NEW.id, NEW.libelle);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_fts_transaction_delete
+        AFTER DELETE ON transactions
+        BEGIN
+            INSERT INTO transactions_fts(transactions_fts, rowid, libelle) VALUES ('delete', OLD.id, OLD.libelle);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_fts_transaction_update
+        AFTER UPDATE OF libelle ON transactions
+        BEGIN
+            INSERT INTO transactions_fts(transactions_fts, rowid, libelle) VALUES ('delete', OLD.id, OLD.libelle);
+            INSERT INTO transactions_fts(rowid, libelle) VALUES (NEW.id, NEW.libelle);
+        END;
+    )";
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, createIndex, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur création index de recherche: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    // Indexer les libellés déjà présents
+    if (sqlite3_exec(mDb, "INSERT INTO transactions_fts(transactions_fts) VALUES ('rebuild');",
+                     nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur indexation des libellés: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool Database::InitializeBalances() {
+    // Première ouverture avec la table balances : la remplir à partir des transactions
+    auto stmt = mStatements.Acquire(StatementId::TOTAL_RESTANT);
+    if (!stmt) {
+        return false;
+    }
+    bool exists = stmt.Step() == SQLITE_ROW;
+    stmt = ScopedStatement();
+
+    if (!exists) {
+        RebuildBalances();
+    }
     return true;
 }
 
+std::vector<QueryPlanStep> Database::AuditQueryPlans(bool onlyIssues) const {
+    std::vector<QueryPlanStep> steps = mStatements.ExplainAll();
+    if (onlyIssues) {
+        steps.erase(std::remove_if(steps.begin(), steps.end(),
+                                   [](const QueryPlanStep& step) { return !step.mFullScan && !step.mTempSort; }),
+                    steps.end());
+    }
+    return steps;
+}
+
 void Database::MigrateTypesTable() {
     // Vérifier si la colonne is_depense existe déjà
     const char* sqlCheck = "PRAGMA table_info(types);";
@@ -147,508 +483,2099 @@ void Database::MigrateTypesTable() {
     }
 }
 
-bool Database::InitializeDefaultTypes() {
-    // CB et CHEQUE sont des dépenses (true = 1)
-    // VIREMENT peut être une recette (false = 0)
-    std::vector<std::pair<std::string, bool>> defaultTypes = {
-        {"CB", true},
-        {"CHEQUE", true},
-        {"VIREMENT", false}
-    };
-    
-    for (const auto& [type, isDepense] : defaultTypes) {
-        std::string sql = "INSERT OR IGNORE INTO types (nom, is_depense) VALUES (?, ?);";
-        sqlite3_stmt* stmt;
-        if (sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-            sqlite3_bind_text(stmt, 1, type.c_str(), -1, SQLITE_TRANSIENT);
-            sqlite3_bind_int(stmt, 2, isDepense ? 1 : 0);
-            sqlite3_step(stmt);
-            sqlite3_finalize(stmt);
-        }
+bool Database::TableExists(const char* table) {
+    sqlite3_stmt* stmt;
+    bool exists = false;
+    if (sqlite3_prepare_v2(mDb, "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?;",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, table, -1, SQLITE_STATIC);
+        exists = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_finalize(stmt);
     }
-    return true;
+    return exists;
 }
 
-bool Database::AddTransaction(const Transaction& transaction) {
-    std::string sql = "INSERT INTO transactions (date, libelle, somme, pointee, type, date_pointee) "
-                      "VALUES (?, ?, ?, ?, ?, ?);";
+int Database::GetSchemaVersion() {
+    return std::atoi(QueryPragma("user_version").c_str());
+}
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return false;
-    }
+bool Database::SetSchemaVersion(int version) {
+    std::string sql = "PRAGMA user_version = " + std::to_string(version) + ";";
+    return sqlite3_exec(mDb, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+}
 
-    std::string dateStr = transaction.GetDate().Format("%Y-%m-%d").ToStdString();
-    sqlite3_bind_text(stmt, 1, dateStr.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, transaction.GetLibelle().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 3, transaction.GetSomme());
-    sqlite3_bind_int(stmt, 4, transaction.IsPointee() ? 1 : 0);
-    sqlite3_bind_text(stmt, 5, transaction.GetType().c_str(), -1, SQLITE_TRANSIENT);
+const Database::Migration Database::kMigrations[] = {
+    {1, "dates en numéros de jour", &Database::MigrateDatesToDayNumbers},
+    {2, "montants en centimes", &Database::MigrateAmountsToCents},
+    {3, "index secondaires", &Database::CreateIndexes},
+    {4, "triggers de la table balances", &Database::CreateBalanceTriggers},
+    {5, "index de recherche des libellés", &Database::CreateSearchIndex},
+    {6, "prochaine échéance des récurrences", &Database::AddRecurringNextExecution},
+    {7, "types en clé étrangère", &Database::MigrateTypesToForeignKey},
+    {8, "agrégats mensuels", &Database::CreateRollupTables},
+    {9, "solde progressif", &Database::CreateRunningBalances},
+};
+
+int Database::GetLatestSchemaVersion() {
+    return std::end(kMigrations)[-1].mVersion;
+}
 
-    if (transaction.GetDatePointee().IsValid()) {
-        sqlite3_bind_text(stmt, 6, transaction.GetDatePointee().Format("%Y-%m-%d").mb_str(), -1, SQLITE_TRANSIENT);
-    } else {
-        sqlite3_bind_null(stmt, 6);
+bool Database::MigrateSchema() {
+    const int latest = GetLatestSchemaVersion();
+    int version = GetSchemaVersion();
+    if (version >= latest) {
+        return true;
     }
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    // Une base neuve est créée directement au schéma de base, sans les
+    // conversions des anciennes versions
+    if (version == 0 && !TableExists("transactions")) {
+        if (!ApplyMigration({kBaseSchemaVersion, "schéma initial", &Database::CreateBaseSchema})) {
+            return false;
+        }
+        version = kBaseSchemaVersion;
+    }
 
-    return rc == SQLITE_DONE;
+    for (const auto& migration : kMigrations) {
+        if (migration.mVersion > version && !ApplyMigration(migration)) {
+            return false;
+        }
+    }
+    return true;
 }
 
-bool Database::UpdateTransaction(const Transaction& transaction) {
-    std::string sql = "UPDATE transactions SET date=?, libelle=?, somme=?, pointee=?, type=?, date_pointee=? "
-                      "WHERE id=?;";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+bool Database::ApplyMigration(const Migration& migration) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, "BEGIN IMMEDIATE;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur début migration: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
         return false;
     }
 
-    std::string dateStr = transaction.GetDate().Format("%Y-%m-%d").ToStdString();
-    sqlite3_bind_text(stmt, 1, dateStr.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, transaction.GetLibelle().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 3, transaction.GetSomme());
-    sqlite3_bind_int(stmt, 4, transaction.IsPointee() ? 1 : 0);
-    sqlite3_bind_text(stmt, 5, transaction.GetType().c_str(), -1, SQLITE_TRANSIENT);
-    if (transaction.GetDatePointee().IsValid()) {
-        sqlite3_bind_text(stmt, 6, transaction.GetDatePointee().Format("%Y-%m-%d").mb_str(), -1, SQLITE_TRANSIENT);
-    } else {
-        sqlite3_bind_null(stmt, 6);
+    const bool success = (this->*migration.mApply)() &&
+                         SetSchemaVersion(migration.mVersion) &&
+                         sqlite3_exec(mDb, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+    if (!success) {
+        std::cerr << "Migration du schéma vers la version " << migration.mVersion
+                  << " (" << migration.mName << ") annulée" << std::endl;
+        sqlite3_exec(mDb, "ROLLBACK;", nullptr, nullptr, nullptr);
     }
-    sqlite3_bind_int(stmt, 7, transaction.GetId());
-
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    return success;
+}
 
-    return rc == SQLITE_DONE;
+bool Database::CreateBaseSchema() {
+    return CreateTables() && InitializeDefaultTypes();
 }
 
-bool Database::DeleteTransaction(int id) {
-    std::string sql = "DELETE FROM transactions WHERE id=?;";
+namespace {
+
+// Colonne date en texte (anciennes bases) ou déjà en numéro de jour
+bool ReadLegacyDate(sqlite3_stmt* stmt, int column, std::optional<int>& day) {
+    switch (sqlite3_column_type(stmt, column)) {
+        case SQLITE_NULL:
+            day = std::nullopt;
+            return true;
+        case SQLITE_INTEGER:
+            day = sqlite3_column_int(stmt, column);
+            return true;
+        default: {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+            day = DayNumber::ParseLegacy(text ? std::string_view(text, sqlite3_column_bytes(stmt, column))
+                                              : std::string_view());
+            return day.has_value();
+        }
+    }
+}
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+// Recopie la table en convertissant les colonnes de dates ; les autres colonnes
+// sont recopiées telles quelles. Les index et triggers sont recréés à l'ouverture.
+// createSql doit créer la table <table>_new
+bool RebuildWithDayNumbers(sqlite3* db, const char* table, const char* createSql,
+                           const std::vector<std::string>& columns,
+                           const std::vector<size_t>& dateColumns,
+                           const std::vector<size_t>& requiredDates) {
+    const std::string newTable = std::string(table) + "_new";
+
+    if (sqlite3_exec(db, createSql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "Erreur création " << newTable << ": " << sqlite3_errmsg(db) << std::endl;
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, id);
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    std::string columnList;
+    std::string placeholders;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        columnList += (i ? ", " : "") + columns[i];
+        placeholders += i ? ", ?" : "?";
+    }
 
-    return rc == SQLITE_DONE;
-}
+    const std::string selectSql = "SELECT " + columnList + " FROM " + table + ";";
+    const std::string insertSql = "INSERT INTO " + newTable + " (" + columnList + ") VALUES (" + placeholders + ");";
 
-Transaction Database::GetTransaction(int id) {
-    std::string sql = "SELECT id, date, libelle, somme, pointee, type FROM transactions WHERE id=?;";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return Transaction();
-    }
+    sqlite3_stmt* select = nullptr;
+    sqlite3_stmt* insert = nullptr;
+    bool success = sqlite3_prepare_v2(db, selectSql.c_str(), -1, &select, nullptr) == SQLITE_OK &&
+                   sqlite3_prepare_v2(db, insertSql.c_str(), -1, &insert, nullptr) == SQLITE_OK;
 
-    sqlite3_bind_int(stmt, 1, id);
+    while (success && sqlite3_step(select) == SQLITE_ROW) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            const int column = static_cast<int>(i);
+            if (std::find(dateColumns.begin(), dateColumns.end(), i) == dateColumns.end()) {
+                sqlite3_bind_value(insert, column + 1, sqlite3_column_value(select, column));
+                continue;
+            }
 
-    Transaction trans;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int transId = sqlite3_column_int(stmt, 0);
-        std::string dateStr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        std::string libelle = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        double somme = sqlite3_column_double(stmt, 3);
-        bool pointee = sqlite3_column_int(stmt, 4) != 0;
-        std::string type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+            std::optional<int> day;
+            bool required = std::find(requiredDates.begin(), requiredDates.end(), i) != requiredDates.end();
+            if (!ReadLegacyDate(select, column, day) && (required || sqlite3_column_bytes(select, column) > 0)) {
+                std::cerr << "Date illisible dans " << table << " (id " << sqlite3_column_int(select, 0)
+                          << ", " << columns[i] << ") : " << sqlite3_column_text(select, column) << std::endl;
+                success = false;
+                break;
+            }
+            SqlTraits<std::optional<int>>::Bind(insert, column + 1, day);
+        }
 
-        wxDateTime date;
-        date.ParseFormat(dateStr, "%Y-%m-%d");
+        if (success && sqlite3_step(insert) != SQLITE_DONE) {
+            std::cerr << "Erreur copie " << table << ": " << sqlite3_errmsg(db) << std::endl;
+            success = false;
+        }
+        sqlite3_reset(insert);
+        sqlite3_clear_bindings(insert);
+    }
 
-        trans = Transaction(transId, date, libelle, somme, pointee, type);
+    sqlite3_finalize(select);
+    sqlite3_finalize(insert);
+    if (!success) {
+        return false;
     }
 
-    sqlite3_finalize(stmt);
-    return trans;
+    const std::string swapSql = std::string("DROP TABLE ") + table + ";" +
+                                "ALTER TABLE " + newTable + " RENAME TO " + table + ";";
+    if (sqlite3_exec(db, swapSql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "Erreur remplacement " << table << ": " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
 }
 
-std::vector<Transaction> Database::GetAllTransactions() {
-    std::vector<Transaction> transactions;
-    std::string sql = "SELECT id, date, libelle, somme, pointee, type, date_pointee FROM transactions ORDER BY date DESC;";
+} // namespace
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return transactions;
+bool Database::MigrateDatesToDayNumbers() {
+    // Bases antérieures au versionnement : tables et colonnes ajoutées au fil
+    // des versions, types par défaut
+    if (!CreateTables()) {
+        return false;
+    }
+    MigrateTypesTable();
+    InitializeDefaultTypes();
+
+    // Les triggers des types font référence à la table transactions reconstruite :
+    // ils sont supprimés ici et recréés par CreateBalanceTriggers()
+    const char* dropTriggers = R"(
+        DROP TRIGGER IF EXISTS trg_balances_type_insert;
+        DROP TRIGGER IF EXISTS trg_balances_type_delete;
+        DROP TRIGGER IF EXISTS trg_balances_type_update;
+    )";
+    if (sqlite3_exec(mDb, dropTriggers, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
     }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        std::string dateStr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        std::string libelle = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        double somme = sqlite3_column_double(stmt, 3);
-        bool pointee = sqlite3_column_int(stmt, 4) != 0;
-        std::string type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+    const char* createTransactions = R"(
+        CREATE TABLE transactions_new (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            date INTEGER NOT NULL,
+            libelle TEXT NOT NULL,
+            somme REAL NOT NULL,
+            pointee INTEGER DEFAULT 0,
+            type TEXT NOT NULL,
+            date_pointee INTEGER
+        );
+    )";
 
-        wxDateTime date;
-        date.ParseFormat(dateStr, "%Y-%m-%d");
+    const char* createRecurring = R"(
+        CREATE TABLE recurring_transactions_new (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            libelle TEXT NOT NULL,
+            somme REAL NOT NULL,
+            type TEXT NOT NULL,
+            recurrence_type INTEGER NOT NULL,
+            start_date INTEGER NOT NULL,
+            end_date INTEGER,
+            last_executed INTEGER,
+            day_of_month INTEGER DEFAULT 1,
+            active INTEGER DEFAULT 1
+        );
+    )";
 
-        Transaction trans(id, date, libelle, somme, pointee, type);
+    return RebuildWithDayNumbers(mDb, "transactions", createTransactions,
+                                 {"id", "date", "libelle", "somme", "pointee", "type", "date_pointee"},
+                                 {1, 6}, {1}) &&
+           RebuildWithDayNumbers(mDb, "recurring_transactions", createRecurring,
+                                 {"id", "libelle", "somme", "type", "recurrence_type", "start_date",
+                                  "end_date", "last_executed", "day_of_month", "active"},
+                                 {5, 6, 7}, {5});
+}
 
-        // Récupérer la date pointée si elle existe
-        if (sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
-            std::string datePointeeStr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
-            wxDateTime datePointee;
-            datePointee.ParseFormat(datePointeeStr, "%Y-%m-%d");
-            trans.SetDatePointee(datePointee);
-        }
+bool Database::MigrateAmountsToCents() {
+    // Comme en v1, les triggers des types sont recréés par CreateBalanceTriggers() ;
+    // la table balances est recréée en centimes puis recalculée par InitializeBalances()
+    const char* migration = R"(
+        DROP TRIGGER IF EXISTS trg_balances_type_insert;
+        DROP TRIGGER IF EXISTS trg_balances_type_delete;
+        DROP TRIGGER IF EXISTS trg_balances_type_update;
 
-        transactions.push_back(trans);
-    }
+        CREATE TABLE transactions_new (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            date INTEGER NOT NULL,
+            libelle TEXT NOT NULL,
+            somme INTEGER NOT NULL,
+            pointee INTEGER DEFAULT 0,
+            type TEXT NOT NULL,
+            date_pointee INTEGER
+        );
+        INSERT INTO transactions_new (id, date, libelle, somme, pointee, type, date_pointee)
+            SELECT id, date, libelle, CAST(ROUND(somme * 100) AS INTEGER), pointee, type, date_pointee
+            FROM transactions;
+        DROP TABLE transactions;
+        ALTER TABLE transactions_new RENAME TO transactions;
 
-    sqlite3_finalize(stmt);
-    return transactions;
-}
+        CREATE TABLE recurring_transactions_new (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            libelle TEXT NOT NULL,
+            somme INTEGER NOT NULL,
+            type TEXT NOT NULL,
+            recurrence_type INTEGER NOT NULL,
+            start_date INTEGER NOT NULL,
+            end_date INTEGER,
+            last_executed INTEGER,
+            day_of_month INTEGER DEFAULT 1,
+            active INTEGER DEFAULT 1
+        );
+        INSERT INTO recurring_transactions_new
+            (id, libelle, somme, type, recurrence_type, start_date, end_date, last_executed, day_of_month, active)
+            SELECT id, libelle, CAST(ROUND(somme * 100) AS INTEGER), type, recurrence_type,
+                   start_date, end_date, last_executed, day_of_month, active
+            FROM recurring_transactions;
+        DROP TABLE recurring_transactions;
+        ALTER TABLE recurring_transactions_new RENAME TO recurring_transactions;
+
+        DROP TABLE balances;
+        CREATE TABLE balances (
+            id INTEGER PRIMARY KEY CHECK (id = 1),
+            total_restant INTEGER NOT NULL DEFAULT 0,
+            total_pointee INTEGER NOT NULL DEFAULT 0
+        );
+    )";
 
-bool Database::AddType(const std::string& type, bool isDepense) {
-    std::string sql = "INSERT INTO types (nom, is_depense) VALUES (?, ?);";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, migration, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur conversion des montants en centimes: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
         return false;
     }
-
-    sqlite3_bind_text(stmt, 1, type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, 2, isDepense ? 1 : 0);
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    return rc == SQLITE_DONE;
+    return true;
 }
 
-bool Database::UpdateType(const std::string& type, bool isDepense) {
-    std::string sql = "UPDATE types SET is_depense=? WHERE nom=?;";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+bool Database::InitializeDefaultTypes() {
+    // CB et CHEQUE sont des dépenses (true = 1)
+    // VIREMENT peut être une recette (false = 0)
+    std::vector<std::pair<std::string, bool>> defaultTypes = {
+        {"CB", true},
+        {"CHEQUE", true},
+        {"VIREMENT", false}
+    };
+
+    // Exécuté par les migrations, avant la préparation du registre
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(mDb, StatementRegistry::GetSql(StatementId::INSERT_DEFAULT_TYPE),
+                           -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erreur préparation types par défaut: " << sqlite3_errmsg(mDb) << std::endl;
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, isDepense ? 1 : 0);
-    sqlite3_bind_text(stmt, 2, type.c_str(), -1, SQLITE_TRANSIENT);
-    rc = sqlite3_step(stmt);
+    bool success = true;
+    for (const auto& [type, isDepense] : defaultTypes) {
+        SqlTraits<std::string>::Bind(stmt, 1, type);
+        SqlTraits<bool>::Bind(stmt, 2, isDepense);
+        success = sqlite3_step(stmt) == SQLITE_DONE && success;
+        sqlite3_reset(stmt);
+    }
     sqlite3_finalize(stmt);
-
-    return rc == SQLITE_DONE;
+    return success;
 }
 
-bool Database::DeleteType(const std::string& type) {
-    std::string sql = "DELETE FROM types WHERE nom=?;";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return false;
-    }
+namespace {
 
-    sqlite3_bind_text(stmt, 1, type.c_str(), -1, SQLITE_TRANSIENT);
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+// Numéro de jour stocké en base, ou NULL si la date est invalide
+std::optional<int> ToDbDate(const wxDateTime& date) {
+    return DayNumber::FromDateTime(date);
+}
 
-    return rc == SQLITE_DONE;
+wxDateTime FromDbDate(int dayNumber) {
+    return DayNumber::ToDateTime(dayNumber);
 }
 
-std::vector<TransactionType> Database::GetAllTypes() {
-    std::vector<TransactionType> types;
-    std::string sql = "SELECT nom, is_depense FROM types ORDER BY nom;";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+// Colonnes : id, date, libelle, somme, pointee, type_id, date_pointee
+Transaction ReadTransactionRow(const ScopedStatement& stmt) {
+    Transaction trans(stmt.Column<int>(0),
+                      FromDbDate(stmt.Column<int>(1)),
+                      stmt.Column<std::string>(2),
+                      stmt.Column<Money>(3),
+                      stmt.Column<bool>(4),
+                      stmt.Column<int>(5));
+
+    // Récupérer la date pointée si elle existe
+    if (!stmt.IsNull(6)) {
+        trans.SetDatePointee(FromDbDate(stmt.Column<int>(6)));
+    }
+    return trans;
+}
+
+} // namespace
+
+bool Database::AddRecurringNextExecution() {
+    const char* alter = R"(
+        ALTER TABLE recurring_transactions ADD COLUMN next_execution_date INTEGER;
+        CREATE INDEX IF NOT EXISTS idx_recurring_next_execution
+            ON recurring_transactions(next_execution_date) WHERE active = 1;
+    )";
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, alter, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur ajout next_execution_date: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    // Calcul initial avec les mêmes règles que l'application ; les requêtes
+    // du registre ne sont pas encore préparées
+    sqlite3_stmt* select = nullptr;
+    sqlite3_stmt* update = nullptr;
+    bool success =
+        sqlite3_prepare_v2(mDb, "SELECT id, recurrence_type, start_date, end_date, last_executed, day_of_month "
+                                "FROM recurring_transactions;", -1, &select, nullptr) == SQLITE_OK &&
+        sqlite3_prepare_v2(mDb, "UPDATE recurring_transactions SET next_execution_date = ? WHERE id = ?;",
+                           -1, &update, nullptr) == SQLITE_OK;
+
+    while (success && sqlite3_step(select) == SQLITE_ROW) {
+        auto readDate = [select](int column) {
+            return sqlite3_column_type(select, column) == SQLITE_NULL
+                       ? wxDateTime() : FromDbDate(sqlite3_column_int(select, column));
+        };
+
+        RecurringTransaction rule(sqlite3_column_int(select, 0), std::string(), Money(), -1,
+                                  static_cast<RecurrenceType>(sqlite3_column_int(select, 1)),
+                                  readDate(2), readDate(3), sqlite3_column_int(select, 5));
+        rule.SetLastExecuted(readDate(4));
+
+        SqlTraits<std::optional<int>>::Bind(update, 1, ToDbDate(rule.GetNextPendingDate()));
+        sqlite3_bind_int(update, 2, rule.GetId());
+        success = sqlite3_step(update) == SQLITE_DONE;
+        sqlite3_reset(update);
+    }
+
+    sqlite3_finalize(select);
+    sqlite3_finalize(update);
+    return success;
+}
+
+bool Database::MigrateTypesToForeignKey() {
+    // Les deux tables sont recopiées avec type_id à la place du nom. Un nom
+    // absent de la table types devient un type (dépense, comme IsDepense le
+    // supposait déjà) : la clé étrangère n'admet plus de type inconnu.
+    // Les triggers et index des anciennes tables disparaissent avec elles ;
+    // balances est vidée puis recalculée par InitializeBalances().
+    const char* migration = R"(
+        DROP TRIGGER IF EXISTS trg_balances_type_insert;
+        DROP TRIGGER IF EXISTS trg_balances_type_delete;
+        DROP TRIGGER IF EXISTS trg_balances_type_update;
+
+        INSERT OR IGNORE INTO types (nom, is_depense)
+            SELECT type, 1 FROM transactions UNION SELECT type, 1 FROM recurring_transactions;
+
+        CREATE TABLE transactions_new (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            date INTEGER NOT NULL,
+            libelle TEXT NOT NULL,
+            somme INTEGER NOT NULL,
+            pointee INTEGER DEFAULT 0,
+            type_id INTEGER NOT NULL REFERENCES types(id),
+            date_pointee INTEGER
+        );
+        INSERT INTO transactions_new (id, date, libelle, somme, pointee, type_id, date_pointee)
+            SELECT transactions.id, date, libelle, somme, pointee, types.id, date_pointee
+            FROM transactions JOIN types ON types.nom = transactions.type;
+        DROP TABLE transactions;
+        ALTER TABLE transactions_new RENAME TO transactions;
+
+        CREATE TABLE recurring_transactions_new (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            libelle TEXT NOT NULL,
+            somme INTEGER NOT NULL,
+            type_id INTEGER NOT NULL REFERENCES types(id),
+            recurrence_type INTEGER NOT NULL,
+            start_date INTEGER NOT NULL,
+            end_date INTEGER,
+            last_executed INTEGER,
+            day_of_month INTEGER DEFAULT 1,
+            active INTEGER DEFAULT 1,
+            next_execution_date INTEGER
+        );
+        INSERT INTO recurring_transactions_new
+            (id, libelle, somme, type_id, recurrence_type, start_date, end_date, last_executed,
+             day_of_month, active, next_execution_date)
+            SELECT recurring_transactions.id, libelle, somme, types.id, recurrence_type, start_date,
+                   end_date, last_executed, day_of_month, active, next_execution_date
+            FROM recurring_transactions JOIN types ON types.nom = recurring_transactions.type;
+        DROP TABLE recurring_transactions;
+        ALTER TABLE recurring_transactions_new RENAME TO recurring_transactions;
+
+        CREATE INDEX idx_transactions_date ON transactions(date, id);
+        CREATE INDEX idx_transactions_totals ON transactions(pointee, type_id, somme);
+        CREATE INDEX idx_transactions_type ON transactions(type_id);
+        CREATE INDEX idx_recurring_start_date ON recurring_transactions(start_date);
+        CREATE INDEX idx_recurring_type ON recurring_transactions(type_id);
+        CREATE INDEX idx_recurring_next_execution
+            ON recurring_transactions(next_execution_date) WHERE active = 1;
+
+        DELETE FROM balances;
+    )";
+
+    // Avec la clé étrangère, un type utilisé ne peut être ni créé avec des
+    // transactions ni supprimé : seul le changement de sens touche les totaux,
+    // et un renommage n'a plus aucun effet sur eux
+    const char* createTriggers = R"(
+        CREATE TRIGGER trg_balances_transaction_insert
+        AFTER INSERT ON transactions
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant +
+                    COALESCE((SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                              FROM types WHERE id = NEW.type_id), 0),
+                total_pointee = total_pointee + CASE WHEN NEW.pointee = 1 THEN
+                    COALESCE((SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                              FROM types WHERE id = NEW.type_id), 0) ELSE 0 END
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER trg_balances_transaction_delete
+        AFTER DELETE ON transactions
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant -
+                    COALESCE((SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                              FROM types WHERE id = OLD.type_id), 0),
+                total_pointee = total_pointee - CASE WHEN OLD.pointee = 1 THEN
+                    COALESCE((SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                              FROM types WHERE id = OLD.type_id), 0) ELSE 0 END
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER trg_balances_transaction_update
+        AFTER UPDATE OF somme, pointee, type_id ON transactions
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant
+                    + COALESCE((SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                                FROM types WHERE id = NEW.type_id), 0)
+                    - COALESCE((SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                                FROM types WHERE id = OLD.type_id), 0),
+                total_pointee = total_pointee
+                    + CASE WHEN NEW.pointee = 1 THEN
+                        COALESCE((SELECT CASE WHEN is_depense = 1 THEN -NEW.somme ELSE NEW.somme END
+                                  FROM types WHERE id = NEW.type_id), 0) ELSE 0 END
+                    - CASE WHEN OLD.pointee = 1 THEN
+                        COALESCE((SELECT CASE WHEN is_depense = 1 THEN -OLD.somme ELSE OLD.somme END
+                                  FROM types WHERE id = OLD.type_id), 0) ELSE 0 END
+            WHERE id = 1;
+        END;
+
+        CREATE TRIGGER trg_balances_type_update
+        AFTER UPDATE OF is_depense ON types
+        WHEN NEW.is_depense <> OLD.is_depense
+        BEGIN
+            UPDATE balances SET
+                total_restant = total_restant + (CASE WHEN NEW.is_depense = 1 THEN -2 ELSE 2 END) *
+                    (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type_id = NEW.id),
+                total_pointee = total_pointee + (CASE WHEN NEW.is_depense = 1 THEN -2 ELSE 2 END) *
+                    (SELECT COALESCE(SUM(somme), 0) FROM transactions WHERE type_id = NEW.id AND pointee = 1)
+            WHERE id = 1;
+        END;
+    )";
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, migration, nullptr, nullptr, &errMsg) != SQLITE_OK ||
+        sqlite3_exec(mDb, createTriggers, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur passage des types en clé étrangère: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    // Triggers de l'index de recherche, supprimés avec l'ancienne table
+    return CreateSearchIndex();
+}
+
+bool Database::CreateRollupTables() {
+    // Un agrégat par mois et par type ; le sens du type est appliqué à la
+    // lecture, un changement de sens ne périme donc aucun mois. Les triggers
+    // ne font que marquer les mois touchés, recalculés par RefreshRollup().
+    const char* createRollup = R"(
+        CREATE TABLE rollup_monthly (
+            month INTEGER NOT NULL,
+            type_id INTEGER NOT NULL,
+            somme INTEGER NOT NULL,
+            nombre INTEGER NOT NULL,
+            PRIMARY KEY (month, type_id)
+        ) WITHOUT ROWID;
+
+        CREATE TABLE rollup_stale (
+            month INTEGER PRIMARY KEY
+        );
+
+        CREATE TRIGGER trg_rollup_transaction_insert
+        AFTER INSERT ON transactions
+        BEGIN
+            INSERT OR IGNORE INTO rollup_stale (month) VALUES (
+                CAST(strftime('%Y', NEW.date * 86400, 'unixepoch') AS INTEGER) * 12 +
+                CAST(strftime('%m', NEW.date * 86400, 'unixepoch') AS INTEGER) - 1);
+        END;
+
+        CREATE TRIGGER trg_rollup_transaction_delete
+        AFTER DELETE ON transactions
+        BEGIN
+            INSERT OR IGNORE INTO rollup_stale (month) VALUES (
+                CAST(strftime('%Y', OLD.date * 86400, 'unixepoch') AS INTEGER) * 12 +
+                CAST(strftime('%m', OLD.date * 86400, 'unixepoch') AS INTEGER) - 1);
+        END;
+
+        CREATE TRIGGER trg_rollup_transaction_update
+        AFTER UPDATE OF date, somme, type_id ON transactions
+        BEGIN
+            INSERT OR IGNORE INTO rollup_stale (month) VALUES (
+                CAST(strftime('%Y', OLD.date * 86400, 'unixepoch') AS INTEGER) * 12 +
+                CAST(strftime('%m', OLD.date * 86400, 'unixepoch') AS INTEGER) - 1), (
+                CAST(strftime('%Y', NEW.date * 86400, 'unixepoch') AS INTEGER) * 12 +
+                CAST(strftime('%m', NEW.date * 86400, 'unixepoch') AS INTEGER) - 1);
+        END;
+
+        INSERT INTO rollup_monthly (month, type_id, somme, nombre)
+            SELECT CAST(strftime('%Y', date * 86400, 'unixepoch') AS INTEGER) * 12 +
+                   CAST(strftime('%m', date * 86400, 'unixepoch') AS INTEGER) - 1,
+                   type_id, SUM(somme), COUNT(*)
+            FROM transactions GROUP BY 1, 2;
+    )";
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, createRollup, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur création des agrégats mensuels: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool Database::CreateRunningBalances() {
+    // Solde après chaque transaction et solde à la fin de chaque mois. Les
+    // triggers ne retiennent que la plus ancienne date modifiée ; la table
+    // est remplie au premier appel de GetRunningBalances().
+    const char* createRunningBalances = R"(
+        CREATE TABLE running_balances (
+            id INTEGER PRIMARY KEY,
+            solde INTEGER NOT NULL
+        );
+
+        CREATE TABLE balance_checkpoints (
+            month INTEGER PRIMARY KEY,
+            solde INTEGER NOT NULL
+        );
+
+        CREATE TABLE running_balance_stale (
+            id INTEGER PRIMARY KEY CHECK (id = 1),
+            from_date INTEGER NOT NULL
+        );
+
+        CREATE TRIGGER trg_running_balance_insert
+        AFTER INSERT ON transactions
+        BEGIN
+            INSERT INTO running_balance_stale (id, from_date) VALUES (1, NEW.date)
+                ON CONFLICT (id) DO UPDATE SET from_date = MIN(from_date, excluded.from_date);
+        END;
+
+        CREATE TRIGGER trg_running_balance_delete
+        AFTER DELETE ON transactions
+        BEGIN
+            DELETE FROM running_balances WHERE id = OLD.id;
+            INSERT INTO running_balance_stale (id, from_date) VALUES (1, OLD.date)
+                ON CONFLICT (id) DO UPDATE SET from_date = MIN(from_date, excluded.from_date);
+        END;
+
+        CREATE TRIGGER trg_running_balance_update
+        AFTER UPDATE OF date, somme, type_id ON transactions
+        BEGIN
+            INSERT INTO running_balance_stale (id, from_date) VALUES (1, MIN(OLD.date, NEW.date))
+                ON CONFLICT (id) DO UPDATE SET from_date = MIN(from_date, excluded.from_date);
+        END;
+
+        -- Changer le sens d'un type périme tout depuis sa première transaction
+        CREATE TRIGGER trg_running_balance_type_update
+        AFTER UPDATE OF is_depense ON types
+        WHEN NEW.is_depense <> OLD.is_depense
+        BEGIN
+            INSERT INTO running_balance_stale (id, from_date)
+                SELECT 1, MIN(date) FROM transactions WHERE type_id = NEW.id
+                HAVING MIN(date) IS NOT NULL
+                ON CONFLICT (id) DO UPDATE SET from_date = MIN(from_date, excluded.from_date);
+        END;
+
+        INSERT INTO running_balance_stale (id, from_date)
+            SELECT 1, MIN(date) FROM transactions WHERE true HAVING MIN(date) IS NOT NULL;
+    )";
+
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, createRunningBalances, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur création du solde progressif: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool Database::BindTransaction(ScopedStatement& stmt, const Transaction& transaction) {
+    stmt.BindAll(ToDbDate(transaction.GetDate()),
+                 transaction.GetLibelle(),
+                 transaction.GetSomme(),
+                 transaction.IsPointee(),
+                 transaction.GetTypeId(),
+                 ToDbDate(transaction.GetDatePointee()));
+    return true;
+}
+
+bool Database::AddTransaction(const Transaction& transaction) {
+    auto stmt = mStatements.Acquire(StatementId::INSERT_TRANSACTION);
+    if (!stmt) {
+        return false;
+    }
+
+    BindTransaction(stmt, transaction);
+    return stmt.Step() == SQLITE_DONE;
+}
+
+bool Database::UpdateTransaction(const Transaction& transaction) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::UPDATE_TRANSACTION);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.BindAll(ToDbDate(transaction.GetDate()),
+                 transaction.GetLibelle(),
+                 transaction.GetSomme(),
+                 transaction.IsPointee(),
+                 transaction.GetTypeId(),
+                 ToDbDate(transaction.GetDatePointee()),
+                 transaction.GetId());
+
+    return stmt.Step() == SQLITE_DONE;
+}
+
+bool Database::DeleteTransaction(int id) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::DELETE_TRANSACTION);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.Bind(1, id);
+    return stmt.Step() == SQLITE_DONE;
+}
+
+Transaction Database::GetTransaction(int id) {
+    Transaction trans = ReadStoredTransaction(id);
+    mPendingWrites.Apply(trans);
+    return trans;
+}
+
+Transaction Database::ReadStoredTransaction(int id) {
+    auto stmt = mStatements.Acquire(StatementId::SELECT_TRANSACTION);
+    if (!stmt) {
+        return Transaction();
+    }
+
+    stmt.Bind(1, id);
+
+    Transaction trans;
+    if (stmt.Step() == SQLITE_ROW) {
+        trans = ReadTransactionRow(stmt);
+    }
+
+    return trans;
+}
+
+Money Database::GetSignedAmount(const Transaction& transaction) const {
+    // Un type inconnu ne compte pas dans les totaux, comme la jointure de ComputeTotals
+    const TransactionType* type = mTypes.FindById(transaction.GetTypeId());
+    if (!type) {
+        return Money();
+    }
+    return type->mIsDepense ? -transaction.GetSomme() : transaction.GetSomme();
+}
+
+std::optional<TransactionDelta> Database::ApplyFieldUpdate(int id, ScopedStatement& stmt) {
+    TransactionDelta delta;
+    delta.mBefore = GetTransaction(id);
+    if (delta.mBefore.GetId() != id) {
+        return std::nullopt;
+    }
+
+    if (stmt.Step() != SQLITE_ROW) {
+        std::cerr << "Erreur modification transaction " << id << ": " << sqlite3_errmsg(mDb) << std::endl;
+        return std::nullopt;
+    }
+    delta.mAfter = ReadTransactionRow(stmt);
+
+    const Money before = GetSignedAmount(delta.mBefore);
+    const Money after = GetSignedAmount(delta.mAfter);
+    delta.mRestantDelta = after - before;
+    delta.mPointeeDelta = (delta.mAfter.IsPointee() ? after : Money()) -
+                          (delta.mBefore.IsPointee() ? before : Money());
+    return delta;
+}
+
+std::optional<TransactionDelta> Database::SetPointee(int id, bool pointee, const wxDateTime& datePointee) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::SET_TRANSACTION_POINTEE);
+    if (!stmt) {
+        return std::nullopt;
+    }
+
+    // La date de pointage n'a de sens que pour une transaction pointée
+    stmt.BindAll(pointee, pointee ? ToDbDate(datePointee) : std::nullopt, id);
+    return ApplyFieldUpdate(id, stmt);
+}
+
+std::optional<TransactionDelta> Database::SetType(int id, int typeId) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::SET_TRANSACTION_TYPE);
+    if (!stmt) {
+        return std::nullopt;
+    }
+
+    stmt.BindAll(typeId, id);
+    return ApplyFieldUpdate(id, stmt);
+}
+
+std::optional<TransactionDelta> Database::SetAmount(int id, Money somme) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::SET_TRANSACTION_AMOUNT);
+    if (!stmt) {
+        return std::nullopt;
+    }
+
+    stmt.BindAll(somme, id);
+    return ApplyFieldUpdate(id, stmt);
+}
+
+std::optional<TransactionDelta> Database::QueuePointee(int id, bool pointee, const wxDateTime& datePointee) {
+    TransactionDelta delta;
+    delta.mBefore = GetTransaction(id);
+    if (delta.mBefore.GetId() != id) {
+        return std::nullopt;
+    }
+
+    const Money signedAmount = GetSignedAmount(delta.mBefore);
+    if (const PendingPointee* pending = mPendingWrites.Find(id)) {
+        mPendingWrites.QueuePointee(pending->mStored, signedAmount, pointee, datePointee);
+    } else {
+        mPendingWrites.QueuePointee(delta.mBefore, signedAmount, pointee, datePointee);
+    }
+
+    delta.mAfter = GetTransaction(id);
+    if (delta.mAfter.IsPointee() != delta.mBefore.IsPointee()) {
+        delta.mPointeeDelta = delta.mAfter.IsPointee() ? signedAmount : -signedAmount;
+    }
+    return delta;
+}
+
+bool Database::FlushPendingWrites() {
+    if (mPendingWrites.IsEmpty() || !mDb) {
+        return true;
+    }
+
+    // Tout ou rien : la file n'est vidée qu'après le COMMIT, un échec
+    // laisse la base intacte et les pointages prêts pour un nouvel essai
+    if (!BeginTransaction()) {
+        std::cerr << "Erreur écriture des pointages: " << sqlite3_errmsg(mDb) << std::endl;
+        return false;
+    }
+
+    {
+        auto stmt = mStatements.Acquire(StatementId::SET_TRANSACTION_POINTEE);
+        if (!stmt) {
+            RollbackTransaction();
+            return false;
+        }
+
+        for (const auto& [id, pending] : mPendingWrites.GetEntries()) {
+            stmt.BindAll(pending.mPointee, ToDbDate(pending.mDatePointee), id);
+            // SQLITE_DONE : la transaction a été supprimée entre-temps
+            const int rc = stmt.Step();
+            if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+                std::cerr << "Erreur pointage transaction " << id << ": " << sqlite3_errmsg(mDb) << std::endl;
+                stmt.Reset();
+                RollbackTransaction();
+                return false;
+            }
+            stmt.Reset();
+        }
+    }
+
+    if (!CommitTransaction()) {
+        RollbackTransaction();
+        return false;
+    }
+
+    mPendingWrites.Clear();
+    return true;
+}
+
+std::vector<Transaction> Database::GetAllTransactions() {
+    FlushPendingWrites();
+
+    std::vector<Transaction> transactions;
+
+    auto stmt = mStatements.Acquire(StatementId::SELECT_ALL_TRANSACTIONS);
+    if (!stmt) {
+        return transactions;
+    }
+
+    while (stmt.Step() == SQLITE_ROW) {
+        transactions.push_back(ReadTransactionRow(stmt));
+    }
+
+    return transactions;
+}
+
+std::vector<Transaction> Database::GetTransactionsBetween(const wxDateTime& from, const wxDateTime& to) {
+    FlushPendingWrites();
+
+    std::vector<Transaction> transactions;
+
+    auto fromDay = DayNumber::FromDateTime(from);
+    auto toDay = DayNumber::FromDateTime(to);
+    if (!fromDay || !toDay) {
+        return transactions;
+    }
+
+    auto stmt = mStatements.Acquire(StatementId::SELECT_TRANSACTIONS_BETWEEN);
+    if (!stmt) {
+        return transactions;
+    }
+
+    stmt.BindAll(*fromDay, *toDay);
+    while (stmt.Step() == SQLITE_ROW) {
+        transactions.push_back(ReadTransactionRow(stmt));
+    }
+
+    return transactions;
+}
+
+namespace {
+
+// Expressions de tri de chaque clé, l'id servant toujours de départage final
+std::vector<const char*> GetSortExpressions(TransactionSortKey sortKey) {
+    switch (sortKey) {
+        case TransactionSortKey::DATE:
+            return {"date"};
+        case TransactionSortKey::LIBELLE:
+            return {"libelle"};
+        case TransactionSortKey::SOMME:
+            return {"somme"};
+        case TransactionSortKey::POINTEE:
+            return {"pointee", "date"};
+        case TransactionSortKey::DATE_POINTEE:
+            return {"IFNULL(date_pointee, 2147483647)", "date"};
+        case TransactionSortKey::TYPE:
+            // Nom lu par jointure (voir BuildTransactionSelect) : parcours des
+            // types dans l'ordre de leur index unique, puis de leurs transactions
+            // par idx_transactions_type, sans tri temporaire
+            return {"types.nom"};
+        case TransactionSortKey::ID:
+        default:
+            return {};
+    }
+}
+
+// Motif LIKE littéral : % et _ sont échappés
+std::string ToLikePattern(const std::string& text) {
+    std::string pattern = "%";
+    for (char c : text) {
+        if (c == '%' || c == '_' || c == '\\') {
+            pattern += '\\';
+        }
+        pattern += c;
+    }
+    return pattern + "%";
+}
+
+// SELECT des transactions suivi des expressions de tri (colonnes 7 et suivantes).
+// Le texte ne dépend que de la forme de l'appel : il est préparé une fois par
+// combinaison puis repris du cache du registre.
+std::string BuildTransactionSelect(TransactionSortKey sortKey, bool ascending,
+                                   const TransactionFilter& filter, bool withCursor, bool withLimit) {
+    const std::vector<const char*> sortExpressions = GetSortExpressions(sortKey);
+    std::string sql = "SELECT transactions.id, date, libelle, somme, pointee, type_id, date_pointee";
+    for (const char* expression : sortExpressions) {
+        sql += std::string(", ") + expression;
+    }
+    // CROSS JOIN impose les types en boucle externe : sans statistiques, le
+    // planificateur parcourrait les transactions puis trierait tout le résultat
+    sql += sortKey == TransactionSortKey::TYPE
+               ? " FROM types CROSS JOIN transactions ON types.id = transactions.type_id WHERE 1"
+               : " FROM transactions WHERE 1";
+    if (filter.mHidePointees) {
+        sql += " AND pointee = 0";
+    }
+    if (!filter.mLibelle.empty()) {
+        sql += " AND libelle LIKE ? ESCAPE '\\'";
+    }
+    if (filter.mTypeId) {
+        sql += " AND type_id = ?";
+    }
+    if (filter.mFrom.IsValid()) {
+        sql += " AND date >= ?";
+    }
+    if (filter.mTo.IsValid()) {
+        sql += " AND date <= ?";
+    }
+
+    const char* direction = ascending ? " ASC" : " DESC";
+    std::string orderBy;
+    std::string rowValue;
+    for (const char* expression : sortExpressions) {
+        orderBy += std::string(expression) + direction + ", ";
+        rowValue += std::string(expression) + ", ";
+    }
+    orderBy += std::string("transactions.id") + direction;
+    rowValue += "transactions.id";
+
+    if (withCursor) {
+        std::string placeholders;
+        for (size_t i = 0; i <= sortExpressions.size(); ++i) {
+            placeholders += i ? ", ?" : "?";
+        }
+        sql += " AND (" + rowValue + (ascending ? ") > (" : ") < (") + placeholders + ")";
+    }
+    sql += " ORDER BY " + orderBy;
+    sql += withLimit ? " LIMIT ?;" : ";";
+    return sql;
+}
+
+// Lie les paramètres des filtres ; retourne l'index du paramètre suivant
+int BindTransactionFilter(ScopedStatement& stmt, const TransactionFilter& filter) {
+    int index = 1;
+    if (!filter.mLibelle.empty()) {
+        stmt.Bind(index++, ToLikePattern(filter.mLibelle));
+    }
+    if (filter.mTypeId) {
+        stmt.Bind(index++, *filter.mTypeId);
+    }
+    if (auto fromDay = DayNumber::FromDateTime(filter.mFrom)) {
+        stmt.Bind(index++, *fromDay);
+    }
+    if (auto toDay = DayNumber::FromDateTime(filter.mTo)) {
+        stmt.Bind(index++, *toDay);
+    }
+    return index;
+}
+
+// Parcours partagé par Database et ReadSnapshot, sur la connexion du registre
+size_t VisitTransactions(StatementRegistry& statements, const TransactionQuery& query,
+                         const std::function<bool(const TransactionRow&)>& visitor) {
+    auto stmt = statements.Acquire(BuildTransactionSelect(query.mSortKey, query.mAscending, query.mFilter,
+                                                          false, false));
+    if (!stmt) {
+        return 0;
+    }
+    BindTransactionFilter(stmt, query.mFilter);
+
+    // Une seule vue, remplie en place à chaque ligne : aucune allocation par ligne
+    TransactionRow row;
+    size_t count = 0;
+    while (stmt.Step() == SQLITE_ROW) {
+        row.mId = stmt.Column<int>(0);
+        row.mDate = stmt.Column<int>(1);
+        row.mLibelle = stmt.Column<std::string_view>(2);
+        row.mSomme = stmt.Column<Money>(3);
+        row.mPointee = stmt.Column<bool>(4);
+        row.mTypeId = stmt.Column<int>(5);
+        row.mDatePointee = stmt.Column<std::optional<int>>(6);
+
+        ++count;
+        if (!visitor(row)) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+// Première colonne de la première ligne d'une requête d'agrégat
+template <typename T>
+T ReadScalar(StatementRegistry& statements, StatementId id) {
+    auto stmt = statements.Acquire(id);
+    if (!stmt || stmt.Step() != SQLITE_ROW) {
+        return T();
+    }
+    return stmt.Column<T>(0);
+}
+
+} // namespace
+
+TransactionPage Database::GetTransactionsPage(TransactionSortKey sortKey, bool ascending,
+                                              const PageCursor& cursor, size_t limit,
+                                              const TransactionFilter& filter) {
+    FlushPendingWrites();
+
+    TransactionPage page;
+    const std::vector<const char*> sortExpressions = GetSortExpressions(sortKey);
+    if (limit == 0 || (!cursor.IsStart() && cursor.mKeys.size() != sortExpressions.size())) {
+        return page;
+    }
+
+    auto stmt = mStatements.Acquire(BuildTransactionSelect(sortKey, ascending, filter,
+                                                           !cursor.IsStart(), true));
+    if (!stmt) {
+        return page;
+    }
+
+    int index = BindTransactionFilter(stmt, filter);
+    if (!cursor.IsStart()) {
+        for (const auto& key : cursor.mKeys) {
+            std::visit([&](const auto& value) { stmt.Bind(index++, value); }, key);
+        }
+        stmt.Bind(index++, cursor.mId);
+    }
+    // Une ligne de plus pour savoir s'il reste une page
+    stmt.Bind(index++, static_cast<int64_t>(limit) + 1);
+
+    page.mTransactions.reserve(limit);
+    while (stmt.Step() == SQLITE_ROW) {
+        if (page.mTransactions.size() == limit) {
+            page.mHasMore = true;
+            break;
+        }
+
+        page.mTransactions.push_back(ReadTransactionRow(stmt));
+
+        page.mNext.mKeys.clear();
+        for (size_t i = 0; i < sortExpressions.size(); ++i) {
+            const int column = 7 + static_cast<int>(i);
+            if (sqlite3_column_type(stmt.Get(), column) == SQLITE_INTEGER) {
+                page.mNext.mKeys.emplace_back(stmt.Column<int64_t>(column));
+            } else {
+                page.mNext.mKeys.emplace_back(stmt.Column<std::string>(column));
+            }
+        }
+        page.mNext.mId = stmt.Column<int>(0);
+    }
+
+    return page;
+}
+
+namespace {
+
+// Longueur en caractères d'un texte UTF-8
+size_t Utf8Length(std::string_view text) {
+    return static_cast<size_t>(std::count_if(text.begin(), text.end(),
+                                             [](char c) { return (c & 0xC0) != 0x80; }));
+}
+
+// Mots de la requête ; un * final (recherche par préfixe) est superflu
+// puisque chaque mot est déjà cherché n'importe où dans le libellé
+std::vector<std::string> SplitSearchWords(const std::string& query) {
+    std::vector<std::string> words;
+    std::istringstream stream(query);
+    std::string word;
+    while (stream >> word) {
+        while (!word.empty() && word.back() == '*') {
+            word.pop_back();
+        }
+        if (!word.empty()) {
+            words.push_back(word);
+        }
+    }
+    return words;
+}
+
+// Chaîne FTS5 littérale : les guillemets sont doublés
+std::string ToFtsPhrase(const std::string& word) {
+    std::string phrase = "\"";
+    for (char c : word) {
+        phrase += c;
+        if (c == '"') {
+            phrase += '"';
+        }
+    }
+    return phrase + "\"";
+}
+
+} // namespace
+
+std::vector<int> Database::SearchTransactions(const std::string& query, size_t limit) {
+    std::vector<int> ids;
+
+    // Le tokenizer trigramme n'indexe pas les fragments plus courts
+    std::string match;
+    for (const auto& word : SplitSearchWords(query)) {
+        if (Utf8Length(word) >= kMinSearchWordLength) {
+            match += (match.empty() ? "" : " AND ") + ToFtsPhrase(word);
+        }
+    }
+    if (match.empty()) {
+        return ids;
+    }
+
+    auto stmt = mStatements.Acquire(
+        "SELECT t.id FROM transactions_fts JOIN transactions t ON t.id = transactions_fts.rowid "
+        "WHERE transactions_fts MATCH ? ORDER BY transactions_fts.rank LIMIT ?;");
+    if (!stmt) {
+        return ids;
+    }
+
+    stmt.Bind(1, match);
+    stmt.Bind(2, limit == 0 ? int64_t(-1) : static_cast<int64_t>(limit));
+
+    while (stmt.Step() == SQLITE_ROW) {
+        ids.push_back(stmt.Column<int>(0));
+    }
+    return ids;
+}
+
+size_t Database::ForEachTransaction(const TransactionQuery& query,
+                                    const std::function<bool(const TransactionRow&)>& visitor) {
+    FlushPendingWrites();
+    return VisitTransactions(mStatements, query, visitor);
+}
+
+bool Database::AddType(const std::string& type, bool isDepense) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::INSERT_TYPE);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.BindAll(type, isDepense);
+    if (stmt.Step() != SQLITE_DONE) {
+        return false;
+    }
+
+    mTypes.Add(TransactionType(type, isDepense, static_cast<int>(sqlite3_last_insert_rowid(mDb))));
+    return true;
+}
+
+void Database::ReloadTypes() {
+    mTypes.Load(GetAllTypes());
+}
+
+bool Database::UpdateType(const std::string& type, bool isDepense) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::UPDATE_TYPE);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.BindAll(isDepense, type);
+    if (stmt.Step() != SQLITE_DONE) {
+        return false;
+    }
+
+    mTypes.Update(type, isDepense);
+    return true;
+}
+
+bool Database::RenameType(const std::string& type, const std::string& newName) {
+    FlushPendingWrites();
+
+    if (newName.empty() || !mTypes.Contains(type) || mTypes.Contains(newName)) {
+        return false;
+    }
+
+    auto stmt = mStatements.Acquire(StatementId::RENAME_TYPE);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.BindAll(newName, type);
+    if (stmt.Step() != SQLITE_DONE) {
+        return false;
+    }
+
+    mTypes.Rename(type, newName);
+    return true;
+}
+
+bool Database::DeleteType(const std::string& type) {
+    FlushPendingWrites();
+
+    auto stmt = mStatements.Acquire(StatementId::DELETE_TYPE);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.Bind(1, type);
+    if (stmt.Step() != SQLITE_DONE) {
+        return false;
+    }
+
+    mTypes.Remove(type);
+    return true;
+}
+
+std::vector<TransactionType> Database::GetAllTypes() {
+    std::vector<TransactionType> types;
+
+    auto stmt = mStatements.Acquire(StatementId::SELECT_ALL_TYPES);
+    if (!stmt) {
         return types;
     }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        std::string nom = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        bool isDepense = sqlite3_column_int(stmt, 1) != 0;
-        types.emplace_back(nom, isDepense);
+    while (stmt.Step() == SQLITE_ROW) {
+        types.emplace_back(stmt.Column<std::string>(1), stmt.Column<bool>(2), stmt.Column<int>(0));
+    }
+
+    return types;
+}
+
+void Database::InstallChangeHooks() {
+    sqlite3_update_hook(mDb, &Database::OnRowChanged, this);
+    sqlite3_commit_hook(mDb, &Database::OnCommit, this);
+    sqlite3_rollback_hook(mDb, &Database::OnRollback, this);
+    mDataVersion = ReadScalar<int64_t>(mStatements, StatementId::DATA_VERSION);
+}
+
+void Database::OnRowChanged(void* database, int operation, const char* dbName,
+                            const char* table, sqlite3_int64 rowId) {
+    ChangeLog& changes = static_cast<Database*>(database)->mChanges;
+    if (std::strcmp(table, "transactions") == 0) {
+        changes.Record(operation == SQLITE_INSERT ? ChangeKind::INSERTED
+                       : operation == SQLITE_DELETE ? ChangeKind::DELETED
+                                                    : ChangeKind::UPDATED, rowId);
+    } else if (std::strcmp(table, "types") == 0) {
+        // Le sens d'un type change l'affichage de toutes ses transactions
+        changes.RecordUnknown();
+    }
+}
+
+int Database::OnCommit(void* database) {
+    static_cast<Database*>(database)->mChanges.Commit();
+    return 0;  // Une valeur non nulle annulerait la validation
+}
+
+void Database::OnRollback(void* database) {
+    static_cast<Database*>(database)->mChanges.Rollback();
+}
+
+void Database::CheckExternalChanges() {
+    // data_version ne change que pour les validations des autres connexions
+    const int64_t dataVersion = ReadScalar<int64_t>(mStatements, StatementId::DATA_VERSION);
+    if (mDataVersion >= 0 && dataVersion != mDataVersion) {
+        mChanges.Invalidate();
+    }
+    mDataVersion = dataVersion;
+}
+
+uint64_t Database::GetDataVersion() {
+    if (mDb) {
+        CheckExternalChanges();
+    }
+    return mChanges.GetVersion();
+}
+
+ChangeSet Database::GetChangesSince(uint64_t version) {
+    if (mDb) {
+        FlushPendingWrites();
+        CheckExternalChanges();
+    }
+    return mChanges.GetChangesSince(version);
+}
+
+Money Database::GetTotalRestant() {
+    return ReadScalar<Money>(mStatements, StatementId::TOTAL_RESTANT);
+}
+
+Money Database::GetTotalPointee() {
+    // Les pointages en attente comptent déjà dans le total affiché
+    return ReadScalar<Money>(mStatements, StatementId::TOTAL_POINTEE) + mPendingWrites.GetPointeeDelta();
+}
+
+int Database::GetTransactionCount() {
+    return ReadScalar<int>(mStatements, StatementId::COUNT_TRANSACTIONS);
+}
+
+namespace {
+
+// Clé de mois des agrégats, comme dans les triggers : année * 12 + mois - 1
+int ToMonthKey(int dayNumber) {
+    int year, month, day;
+    DayNumber::ToCivil(dayNumber, year, month, day);
+    return year * 12 + month - 1;
+}
+
+} // namespace
+
+bool Database::RefreshRollup(int fromMonth, int toMonth) {
+    std::vector<int> staleMonths;
+    {
+        auto stmt = mStatements.Acquire(StatementId::SELECT_STALE_ROLLUP_MONTHS);
+        if (!stmt) {
+            return false;
+        }
+        stmt.BindAll(fromMonth, toMonth);
+        while (stmt.Step() == SQLITE_ROW) {
+            staleMonths.push_back(stmt.Column<int>(0));
+        }
+    }
+
+    // Aucune écriture depuis le dernier appel : rien à recalculer
+    if (staleMonths.empty()) {
+        return true;
+    }
+
+    if (!BeginTransaction()) {
+        return false;
+    }
+
+    {
+        auto remove = mStatements.Acquire(StatementId::DELETE_ROLLUP_MONTH);
+        auto compute = mStatements.Acquire(StatementId::COMPUTE_ROLLUP_MONTH);
+        auto clear = mStatements.Acquire(StatementId::CLEAR_STALE_ROLLUP_MONTH);
+        if (!remove || !compute || !clear) {
+            RollbackTransaction();
+            return false;
+        }
+
+        for (int month : staleMonths) {
+            const int year = month / 12;
+            const int monthOfYear = month % 12 + 1;
+            const int firstDay = DayNumber::FromCivil(year, monthOfYear, 1);
+            const int lastDay = firstDay + DayNumber::DaysInMonth(year, monthOfYear) - 1;
+
+            remove.Bind(1, month);
+            compute.BindAll(month, firstDay, lastDay);
+            clear.Bind(1, month);
+            const bool success = remove.Step() == SQLITE_DONE &&
+                                 compute.Step() == SQLITE_DONE &&
+                                 clear.Step() == SQLITE_DONE;
+            remove.Reset();
+            compute.Reset();
+            clear.Reset();
+            if (!success) {
+                std::cerr << "Erreur calcul des agrégats du mois " << monthOfYear << "/" << year
+                          << ": " << sqlite3_errmsg(mDb) << std::endl;
+                RollbackTransaction();
+                return false;
+            }
+        }
+    }
+
+    if (!CommitTransaction()) {
+        RollbackTransaction();
+        return false;
+    }
+    return true;
+}
+
+std::vector<RollupRow> Database::GetRollup(RollupGranularity granularity, RollupGroupBy groupBy,
+                                           const wxDateTime& from, const wxDateTime& to) {
+    std::vector<RollupRow> rows;
+
+    const auto fromDay = DayNumber::FromDateTime(from);
+    const auto toDay = DayNumber::FromDateTime(to);
+    const int fromMonth = fromDay ? ToMonthKey(*fromDay) : std::numeric_limits<int>::min();
+    const int toMonth = toDay ? ToMonthKey(*toDay) : std::numeric_limits<int>::max();
+    if (fromMonth > toMonth || !RefreshRollup(fromMonth, toMonth)) {
+        return rows;
+    }
+
+    auto stmt = mStatements.Acquire(StatementId::SELECT_ROLLUP);
+    if (!stmt) {
+        return rows;
+    }
+    stmt.BindAll(fromMonth, toMonth);
+
+    // Quelques centaines de lignes mensuelles au plus : trimestres, années et
+    // sens des types sont calculés ici plutôt que par un second GROUP BY
+    std::map<std::tuple<int, int, int>, RollupRow> groups;
+    while (stmt.Step() == SQLITE_ROW) {
+        const int month = stmt.Column<int>(0);
+        const int typeId = stmt.Column<int>(1);
+        const Money somme = stmt.Column<Money>(2);
+
+        const int year = month / 12;
+        int period = 0;
+        if (granularity == RollupGranularity::MONTH) {
+            period = month % 12 + 1;
+        } else if (granularity == RollupGranularity::QUARTER) {
+            period = month % 12 / 3 + 1;
+        }
+        const int groupType = groupBy == RollupGroupBy::TYPE ? typeId : -1;
+
+        RollupRow& row = groups[{year, period, groupType}];
+        row.mYear = year;
+        row.mPeriod = period;
+        row.mTypeId = groupType;
+        if (mTypes.IsDepense(typeId)) {
+            row.mDepenses += somme;
+        } else {
+            row.mRecettes += somme;
+        }
+        row.mCount += stmt.Column<int>(3);
     }
 
-    sqlite3_finalize(stmt);
-    return types;
+    rows.reserve(groups.size());
+    for (auto& [key, row] : groups) {
+        rows.push_back(row);
+    }
+    return rows;
 }
 
-bool Database::IsTypeDepense(const std::string& type) {
-    std::string sql = "SELECT is_depense FROM types WHERE nom=?;";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return true;  // Par défaut, considérer comme dépense
+bool Database::RefreshRunningBalances() {
+    std::optional<int> fromDay;
+    {
+        auto stmt = mStatements.Acquire(StatementId::SELECT_RUNNING_BALANCE_STALE);
+        if (!stmt) {
+            return false;
+        }
+        if (stmt.Step() == SQLITE_ROW) {
+            fromDay = stmt.Column<int>(0);
+        }
     }
 
-    sqlite3_bind_text(stmt, 1, type.c_str(), -1, SQLITE_TRANSIENT);
-    
-    bool isDepense = true;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        isDepense = sqlite3_column_int(stmt, 0) != 0;
+    // Aucune modification depuis le dernier calcul
+    if (!fromDay) {
+        return true;
     }
 
-    sqlite3_finalize(stmt);
-    return isDepense;
-}
-
-double Database::GetTotalRestant() {
-    std::string sql = R"(
-        SELECT SUM(
-            CASE 
-                WHEN types.is_depense = 1 THEN -transactions.somme
-                ELSE transactions.somme
-            END
-        )
-        FROM transactions
-        JOIN types ON transactions.type = types.nom;
-    )";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return 0.0;
+    // Le suffixe repart du début du mois, juste après le point de contrôle
+    // précédent ; les points de contrôle suivants sont lus dans rollup_monthly
+    const int fromMonth = ToMonthKey(*fromDay);
+    const int firstDay = DayNumber::FromCivil(fromMonth / 12, fromMonth % 12 + 1, 1);
+    if (!RefreshRollup(fromMonth, std::numeric_limits<int>::max())) {
+        return false;
     }
 
-    double total = 0.0;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        total = sqlite3_column_double(stmt, 0);
+    if (!BeginTransaction()) {
+        return false;
     }
 
-    sqlite3_finalize(stmt);
-    return total;
-}
-
-double Database::GetTotalPointee() {
-    std::string sql = R"(
-        SELECT SUM(
-            CASE 
-                WHEN types.is_depense = 1 THEN -transactions.somme
-                ELSE transactions.somme
-            END
-        )
-        FROM transactions
-        JOIN types ON transactions.type = types.nom
-        WHERE transactions.pointee = 1;
-    )";
-    
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return 0.0;
+    bool success = false;
+    {
+        auto checkpoint = mStatements.Acquire(StatementId::SELECT_BALANCE_CHECKPOINT);
+        auto removeCheckpoints = mStatements.Acquire(StatementId::DELETE_BALANCE_CHECKPOINTS);
+        auto computeBalances = mStatements.Acquire(StatementId::COMPUTE_RUNNING_BALANCES);
+        auto computeCheckpoints = mStatements.Acquire(StatementId::COMPUTE_BALANCE_CHECKPOINTS);
+        auto clear = mStatements.Acquire(StatementId::CLEAR_RUNNING_BALANCE_STALE);
+        if (checkpoint && removeCheckpoints && computeBalances && computeCheckpoints && clear) {
+            Money base;
+            checkpoint.Bind(1, fromMonth);
+            if (checkpoint.Step() == SQLITE_ROW) {
+                base = checkpoint.Column<Money>(0);
+            }
+
+            removeCheckpoints.Bind(1, fromMonth);
+            computeBalances.BindAll(base, firstDay);
+            computeCheckpoints.BindAll(base, fromMonth);
+            success = removeCheckpoints.Step() == SQLITE_DONE &&
+                      computeBalances.Step() == SQLITE_DONE &&
+                      computeCheckpoints.Step() == SQLITE_DONE &&
+                      clear.Step() == SQLITE_DONE;
+        }
+    }
+
+    if (!success) {
+        std::cerr << "Erreur calcul du solde progressif: " << sqlite3_errmsg(mDb) << std::endl;
+        RollbackTransaction();
+        return false;
+    }
+    if (!CommitTransaction()) {
+        RollbackTransaction();
+        return false;
     }
+    return true;
+}
 
-    double total = 0.0;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        total = sqlite3_column_double(stmt, 0);
+std::unordered_map<int, Money> Database::GetRunningBalances() {
+    std::unordered_map<int, Money> balances;
+    if (!RefreshRunningBalances()) {
+        return balances;
     }
 
-    sqlite3_finalize(stmt);
-    return total;
+    auto stmt = mStatements.Acquire(StatementId::SELECT_RUNNING_BALANCES);
+    if (!stmt) {
+        return balances;
+    }
+    while (stmt.Step() == SQLITE_ROW) {
+        balances.emplace(stmt.Column<int>(0), stmt.Column<Money>(1));
+    }
+    return balances;
 }
 
-int Database::GetTransactionCount() {
-    std::string sql = "SELECT COUNT(*) FROM transactions;";
+ReadSnapshot Database::OpenSnapshot() {
+    if (!mDb) {
+        return ReadSnapshot();
+    }
+    // Jamais d'attente ici : le thread de la base bloqué sur le pool bloquerait l'interface
+    if (ReaderConnection* connection = mReaders.TryAcquire()) {
+        return ReadSnapshot(connection->mDb, &connection->mStatements, &mReaders, connection);
+    }
+    return ReadSnapshot(mDb, &mStatements, nullptr, nullptr);
+}
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return 0;
+ReadSnapshot Database::OpenReaderSnapshot() {
+    if (ReaderConnection* connection = mReaders.Acquire()) {
+        return ReadSnapshot(connection->mDb, &connection->mStatements, &mReaders, connection);
     }
+    return ReadSnapshot();
+}
 
-    int count = 0;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        count = sqlite3_column_int(stmt, 0);
+ReadSnapshot::ReadSnapshot(sqlite3* db, StatementRegistry* statements,
+                           ReaderPool* pool, ReaderConnection* connection)
+    : mDb(db), mStatements(statements), mPool(pool), mConnection(connection) {
+    // Une transaction de lecture ne fixe son instantané qu'à la première
+    // lecture : on la fait tout de suite pour que l'ouverture soit le point de référence
+    char* errMsg = nullptr;
+    if (sqlite3_exec(mDb, "BEGIN; SELECT count(*) FROM sqlite_schema;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erreur ouverture instantané: " << (errMsg ? errMsg : "") << std::endl;
+        sqlite3_free(errMsg);
+        if (sqlite3_get_autocommit(mDb) == 0) {
+            sqlite3_exec(mDb, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+        Release();
     }
+}
 
-    sqlite3_finalize(stmt);
-    return count;
+ReadSnapshot::~ReadSnapshot() {
+    if (mDb) {
+        sqlite3_exec(mDb, "COMMIT;", nullptr, nullptr, nullptr);
+    }
+    Release();
 }
 
-std::string Database::GetDatabaseInfo() {
-    std::ostringstream info;
-    info << "Chemin de la base : " << mDbPath << "\n";
-    info << "Nombre de transactions : " << GetTransactionCount() << "\n";
-    info << "Total restant : " << GetTotalRestant() << " €\n";
-    info << "Total pointé : " << GetTotalPointee() << " €\n";
-    return info.str();
+ReadSnapshot::ReadSnapshot(ReadSnapshot&& other) noexcept
+    : mDb(std::exchange(other.mDb, nullptr)),
+      mStatements(std::exchange(other.mStatements, nullptr)),
+      mPool(std::exchange(other.mPool, nullptr)),
+      mConnection(std::exchange(other.mConnection, nullptr)) {}
+
+ReadSnapshot& ReadSnapshot::operator=(ReadSnapshot&& other) noexcept {
+    if (this != &other) {
+        ReadSnapshot released(std::move(*this));
+        mDb = std::exchange(other.mDb, nullptr);
+        mStatements = std::exchange(other.mStatements, nullptr);
+        mPool = std::exchange(other.mPool, nullptr);
+        mConnection = std::exchange(other.mConnection, nullptr);
+    }
+    return *this;
 }
 
-bool Database::AddRecurringTransaction(const RecurringTransaction& trans) {
-    const char* sql = R"(
-        INSERT INTO recurring_transactions 
-        (libelle, somme, type, recurrence_type, start_date, end_date, day_of_month, active)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?);
-    )";
+void ReadSnapshot::Release() {
+    if (mPool) {
+        mPool->Release(mConnection);
+    }
+    mDb = nullptr;
+    mStatements = nullptr;
+    mPool = nullptr;
+    mConnection = nullptr;
+}
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(mDb, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+size_t ReadSnapshot::ForEachTransaction(const TransactionQuery& query,
+                                        const std::function<bool(const TransactionRow&)>& visitor) {
+    return mStatements ? VisitTransactions(*mStatements, query, visitor) : 0;
+}
+
+int ReadSnapshot::GetTransactionCount() {
+    return mStatements ? ReadScalar<int>(*mStatements, StatementId::COUNT_TRANSACTIONS) : 0;
+}
+
+Money ReadSnapshot::GetTotalRestant() {
+    return mStatements ? ReadScalar<Money>(*mStatements, StatementId::TOTAL_RESTANT) : Money();
+}
+
+Money ReadSnapshot::GetTotalPointee() {
+    return mStatements ? ReadScalar<Money>(*mStatements, StatementId::TOTAL_POINTEE) : Money();
+}
+
+bool ReadSnapshot::BackupTo(const std::string& destPath, int pagesPerStep,
+                            const std::function<bool(int, int)>& progress) {
+    if (!mDb) {
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, trans.GetLibelle().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 2, trans.GetSomme());
-    sqlite3_bind_text(stmt, 3, trans.GetType().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, 4, static_cast<int>(trans.GetRecurrence()));
-    sqlite3_bind_text(stmt, 5, trans.GetStartDate().FormatISODate().mb_str(), -1, SQLITE_TRANSIENT);
-    
-    if (trans.GetEndDate().IsValid()) {
-        sqlite3_bind_text(stmt, 6, trans.GetEndDate().FormatISODate().mb_str(), -1, SQLITE_TRANSIENT);
-    } else {
-        sqlite3_bind_null(stmt, 6);
+    // Ne jamais écraser la base elle-même
+    std::error_code ec;
+    if (std::filesystem::equivalent(destPath, sqlite3_db_filename(mDb, "main"), ec)) {
+        std::cerr << "Erreur sauvegarde: la destination est la base ouverte" << std::endl;
+        return false;
     }
-    
-    sqlite3_bind_int(stmt, 7, trans.GetDayOfMonth());
-    sqlite3_bind_int(stmt, 8, trans.IsActive() ? 1 : 0);
 
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    sqlite3_finalize(stmt);
-    return success;
-}
+    std::remove(destPath.c_str());
+    std::remove((destPath + "-journal").c_str());
 
-bool Database::UpdateRecurringTransaction(const RecurringTransaction& trans) {
-    const char* sql = R"(
-        UPDATE recurring_transactions 
-        SET libelle = ?, somme = ?, type = ?, recurrence_type = ?,
-            start_date = ?, end_date = ?, last_executed = ?, 
-            day_of_month = ?, active = ?
-        WHERE id = ?;
-    )";
+    sqlite3* dest = nullptr;
+    if (sqlite3_open(destPath.c_str(), &dest) != SQLITE_OK) {
+        std::cerr << "Erreur ouverture sauvegarde: " << sqlite3_errmsg(dest) << std::endl;
+        sqlite3_close(dest);
+        return false;
+    }
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(mDb, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    // La source est lue dans la transaction de l'instantané : la copie reste
+    // cohérente et n'est jamais relancée par les écritures faites entre deux étapes
+    sqlite3_backup* backup = sqlite3_backup_init(dest, "main", mDb, "main");
+    if (!backup) {
+        std::cerr << "Erreur initialisation sauvegarde: " << sqlite3_errmsg(dest) << std::endl;
+        sqlite3_close(dest);
+        std::remove(destPath.c_str());
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, trans.GetLibelle().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 2, trans.GetSomme());
-    sqlite3_bind_text(stmt, 3, trans.GetType().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, 4, static_cast<int>(trans.GetRecurrence()));
-    sqlite3_bind_text(stmt, 5, trans.GetStartDate().FormatISODate().mb_str(), -1, SQLITE_TRANSIENT);
-    
-    if (trans.GetEndDate().IsValid()) {
-        sqlite3_bind_text(stmt, 6, trans.GetEndDate().FormatISODate().mb_str(), -1, SQLITE_TRANSIENT);
-    } else {
-        sqlite3_bind_null(stmt, 6);
+    bool cancelled = false;
+    int rc;
+    do {
+        rc = sqlite3_backup_step(backup, pagesPerStep);
+        if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+            sqlite3_sleep(10);
+        }
+        if (progress && !progress(sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup))) {
+            cancelled = true;
+            break;
+        }
+    } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+    sqlite3_backup_finish(backup);
+    bool ok = !cancelled && rc == SQLITE_DONE;
+    if (!ok && !cancelled) {
+        std::cerr << "Erreur sauvegarde: " << sqlite3_errstr(rc) << std::endl;
     }
-    
-    if (trans.GetLastExecuted().IsValid()) {
-        sqlite3_bind_text(stmt, 7, trans.GetLastExecuted().FormatISODate().mb_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_close(dest);
+    if (!ok) {
+        std::remove(destPath.c_str());
+    }
+    return ok;
+}
+
+BalanceReport Database::RebuildBalances() {
+    FlushPendingWrites();
+
+    BalanceReport report;
+    report.mStoredRestant = GetTotalRestant();
+    report.mStoredPointee = GetTotalPointee();
+
+    {
+        auto stmt = mStatements.Acquire(StatementId::COMPUTE_TOTALS);
+        if (stmt && stmt.Step() == SQLITE_ROW) {
+            report.mComputedRestant = stmt.Column<Money>(0);
+            report.mComputedPointee = stmt.Column<Money>(1);
+        }
+    }
+
+    auto stmt = mStatements.Acquire(StatementId::STORE_BALANCES);
+    if (stmt) {
+        stmt.BindAll(report.mComputedRestant, report.mComputedPointee);
+        if (stmt.Step() != SQLITE_DONE) {
+            std::cerr << "Erreur mise à jour balances: " << sqlite3_errmsg(mDb) << std::endl;
+        }
+    }
+
+    return report;
+}
+
+std::string Database::GetDatabaseInfo() {
+    std::ostringstream info;
+    info << "Chemin de la base : " << mDbPath << "\n";
+    info << "Version du schéma : " << GetSchemaVersion() << "\n";
+    {
+        // Compte et totaux lus sur un même instantané
+        FlushPendingWrites();
+        ReadSnapshot snapshot = OpenSnapshot();
+        info << "Nombre de transactions : " << snapshot.GetTransactionCount() << "\n";
+        info << "Total restant : " << snapshot.GetTotalRestant().ToString() << " €\n";
+        info << "Total pointé : " << snapshot.GetTotalPointee().ToString() << " €\n";
+    }
+    info << "Connexions de lecture : " << mReaders.GetSize()
+         << (mReaders.IsOpen() ? "" : " (instantanés sur la connexion d'écriture)") << "\n";
+
+    info << "\nConnexion SQLite :\n" << GetConnectionInfo();
+
+    auto planIssues = AuditQueryPlans();
+    info << "\nPlans d'exécution : ";
+    if (planIssues.empty()) {
+        info << "aucun parcours complet de table\n";
     } else {
-        sqlite3_bind_null(stmt, 7);
+        info << planIssues.size() << " étape(s) à surveiller\n";
+        for (const auto& step : planIssues) {
+            info << "  " << step.mName << " : " << step.mDetail
+                 << (step.mFullScan ? " [parcours complet]" : " [tri temporaire]") << "\n";
+        }
     }
-    
-    sqlite3_bind_int(stmt, 8, trans.GetDayOfMonth());
-    sqlite3_bind_int(stmt, 9, trans.IsActive() ? 1 : 0);
-    sqlite3_bind_int(stmt, 10, trans.GetId());
 
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    sqlite3_finalize(stmt);
-    return success;
+    info << "\nRequêtes préparées (appels / temps cumulé) :\n";
+    for (const auto& stats : mStatements.GetStats()) {
+        if (stats.mCalls == 0) {
+            continue;
+        }
+        info << "  " << stats.mName << " : " << stats.mCalls << " / "
+             << std::fixed << std::setprecision(3) << stats.GetTotalMs() << " ms\n";
+    }
+    return info.str();
+}
+
+bool Database::AddRecurringTransaction(const RecurringTransaction& trans) {
+    auto stmt = mStatements.Acquire(StatementId::INSERT_RECURRING);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.BindAll(trans.GetLibelle(),
+                 trans.GetSomme(),
+                 trans.GetTypeId(),
+                 static_cast<int>(trans.GetRecurrence()),
+                 ToDbDate(trans.GetStartDate()),
+                 ToDbDate(trans.GetEndDate()),
+                 trans.GetDayOfMonth(),
+                 trans.IsActive(),
+                 ToDbDate(trans.GetNextPendingDate()));
+
+    return stmt.Step() == SQLITE_DONE;
+}
+
+bool Database::UpdateRecurringTransaction(const RecurringTransaction& trans) {
+    auto stmt = mStatements.Acquire(StatementId::UPDATE_RECURRING);
+    if (!stmt) {
+        return false;
+    }
+
+    stmt.BindAll(trans.GetLibelle(),
+                 trans.GetSomme(),
+                 trans.GetTypeId(),
+                 static_cast<int>(trans.GetRecurrence()),
+                 ToDbDate(trans.GetStartDate()),
+                 ToDbDate(trans.GetEndDate()),
+                 ToDbDate(trans.GetLastExecuted()),
+                 trans.GetDayOfMonth(),
+                 trans.IsActive(),
+                 ToDbDate(trans.GetNextPendingDate()),
+                 trans.GetId());
+
+    return stmt.Step() == SQLITE_DONE;
 }
 
 bool Database::DeleteRecurringTransaction(int id) {
-    const char* sql = "DELETE FROM recurring_transactions WHERE id = ?;";
-    
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(mDb, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    auto stmt = mStatements.Acquire(StatementId::DELETE_RECURRING);
+    if (!stmt) {
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, id);
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    sqlite3_finalize(stmt);
-    return success;
+    stmt.Bind(1, id);
+    return stmt.Step() == SQLITE_DONE;
 }
 
 std::vector<RecurringTransaction> Database::GetAllRecurringTransactions() {
-    std::vector<RecurringTransaction> transactions;
-    const char* sql = "SELECT * FROM recurring_transactions ORDER BY start_date DESC;";
-
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(mDb, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        return transactions;
+    auto stmt = mStatements.Acquire(StatementId::SELECT_ALL_RECURRING);
+    if (!stmt) {
+        return {};
     }
+    return ReadRecurringRows(stmt);
+}
+
+std::vector<RecurringTransaction> Database::ReadRecurringRows(ScopedStatement& stmt) {
+    std::vector<RecurringTransaction> transactions;
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        std::string libelle = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        double somme = sqlite3_column_double(stmt, 2);
-        std::string type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        auto recurrence = static_cast<RecurrenceType>(sqlite3_column_int(stmt, 4));
-        
-        wxDateTime startDate;
-        startDate.ParseISODate(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5)));
-        
+    while (stmt.Step() == SQLITE_ROW) {
         wxDateTime endDate;
-        if (sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
-            endDate.ParseISODate(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)));
-        }
-        
-        int dayOfMonth = sqlite3_column_int(stmt, 8);
-        bool active = sqlite3_column_int(stmt, 9) != 0;
-        
-        RecurringTransaction trans(id, libelle, somme, type, recurrence, 
-                                  startDate, endDate, dayOfMonth, active);
-        
-        if (sqlite3_column_type(stmt, 7) != SQLITE_NULL) {
-            wxDateTime lastExecuted;
-            lastExecuted.ParseISODate(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 7)));
-            trans.SetLastExecuted(lastExecuted);
-        }
-        
+        if (!stmt.IsNull(6)) {
+            endDate = FromDbDate(stmt.Column<int>(6));
+        }
+
+        RecurringTransaction trans(stmt.Column<int>(0),
+                                   stmt.Column<std::string>(1),
+                                   stmt.Column<Money>(2),
+                                   stmt.Column<int>(3),
+                                   static_cast<RecurrenceType>(stmt.Column<int>(4)),
+                                   FromDbDate(stmt.Column<int>(5)),
+                                   endDate,
+                                   stmt.Column<int>(8),
+                                   stmt.Column<bool>(9));
+
+        if (!stmt.IsNull(7)) {
+            trans.SetLastExecuted(FromDbDate(stmt.Column<int>(7)));
+        }
+
         transactions.push_back(trans);
     }
 
-    sqlite3_finalize(stmt);
     return transactions;
 }
 
-int Database::ExecutePendingRecurringTransactions() {
-    auto recurringTrans = GetAllRecurringTransactions();
-    int count = 0;
-    
-    for (auto& recurring : recurringTrans) {
-        if (recurring.ShouldExecuteToday()) {
-            // Créer une transaction normale
+std::vector<RecurringOccurrence> Database::GetPendingRecurringOccurrences(const wxDateTime& until) {
+    std::vector<RecurringOccurrence> occurrences;
+
+    // Seules les règles actives dont l'échéance est passée sont lues
+    std::vector<RecurringTransaction> dueRules;
+    {
+        auto stmt = mStatements.Acquire(StatementId::SELECT_DUE_RECURRING);
+        if (!stmt) {
+            return occurrences;
+        }
+        stmt.Bind(1, ToDbDate(until));
+        dueRules = ReadRecurringRows(stmt);
+    }
+
+    for (const auto& recurring : dueRules) {
+        for (const auto& date : recurring.GetPendingOccurrences(until)) {
             Transaction trans;
-            trans.SetDate(wxDateTime::Today());
+            trans.SetDate(date);
             trans.SetLibelle(recurring.GetLibelle());
             trans.SetSomme(recurring.GetSomme());
-            trans.SetType(recurring.GetType());
+            trans.SetTypeId(recurring.GetTypeId());
             trans.SetPointee(false);
-            
-            if (AddTransaction(trans)) {
-                // Mettre à jour la date de dernière exécution
-                recurring.SetLastExecuted(wxDateTime::Today());
-                UpdateRecurringTransaction(recurring);
-                count++;
+            occurrences.push_back({recurring.GetId(), std::move(trans)});
+        }
+    }
+
+    std::stable_sort(occurrences.begin(), occurrences.end(),
+                     [](const RecurringOccurrence& a, const RecurringOccurrence& b) {
+                         return a.mTransaction.GetDate() < b.mTransaction.GetDate();
+                     });
+    return occurrences;
+}
+
+int Database::ApplyRecurringOccurrences(const std::vector<RecurringOccurrence>& occurrences) {
+    if (occurrences.empty()) {
+        return 0;
+    }
+
+    FlushPendingWrites();
+    ScopedConnectionProfile bulkProfile(*this, ConnectionProfile::BulkLoad(mProfile));
+
+    if (!BeginTransaction()) {
+        std::cerr << "Erreur rattrapage des récurrences: " << sqlite3_errmsg(mDb) << std::endl;
+        return -1;
+    }
+
+    // Dernière exécution relue dans la transaction : un aperçu appliqué deux
+    // fois ne crée pas de doublons
+    std::map<int, RecurringTransaction> rules;
+    for (auto& recurring : GetAllRecurringTransactions()) {
+        rules.emplace(recurring.GetId(), std::move(recurring));
+    }
+
+    int count = 0;
+    std::map<int, wxDateTime> executed;
+    {
+        auto insert = mStatements.Acquire(StatementId::INSERT_TRANSACTION);
+        if (!insert) {
+            RollbackTransaction();
+            return -1;
+        }
+
+        for (const auto& occurrence : occurrences) {
+            auto rule = rules.find(occurrence.mRecurringId);
+            const wxDateTime& date = occurrence.mTransaction.GetDate();
+            if (rule == rules.end() ||
+                (rule->second.GetLastExecuted().IsValid() && !(rule->second.GetLastExecuted() < date))) {
+                continue;
+            }
+
+            if (!BindTransaction(insert, occurrence.mTransaction) || insert.Step() != SQLITE_DONE) {
+                std::cerr << "Erreur insertion récurrence " << occurrence.mRecurringId << ": "
+                          << sqlite3_errmsg(mDb) << std::endl;
+                insert.Reset();
+                RollbackTransaction();
+                return -1;
+            }
+            insert.Reset();
+            ++count;
+
+            wxDateTime& latest = executed[occurrence.mRecurringId];
+            if (!latest.IsValid() || latest < date) {
+                latest = date;
             }
         }
     }
-    
+
+    {
+        auto update = mStatements.Acquire(StatementId::SET_RECURRING_LAST_EXECUTED);
+        if (!update) {
+            RollbackTransaction();
+            return -1;
+        }
+
+        for (const auto& [id, date] : executed) {
+            RecurringTransaction& rule = rules.at(id);
+            rule.SetLastExecuted(date);
+            update.BindAll(ToDbDate(date), ToDbDate(rule.GetNextPendingDate()), id);
+            if (update.Step() != SQLITE_DONE) {
+                std::cerr << "Erreur mise à jour récurrence " << id << ": " << sqlite3_errmsg(mDb) << std::endl;
+                update.Reset();
+                RollbackTransaction();
+                return -1;
+            }
+            update.Reset();
+        }
+    }
+
+    if (!CommitTransaction()) {
+        RollbackTransaction();
+        return -1;
+    }
     return count;
 }
 
-bool Database::ImportTransactionsFromCSV(const std::vector<std::vector<std::string>>& csvData,
-                                         int dateColumn, int libelleColumn, int sommeColumn,
-                                         int typeColumn, const std::string& defaultType,
-                                         bool pointeeByDefault) {
-    int successCount = 0;
-    int errorCount = 0;
+int Database::ExecutePendingRecurringTransactions() {
+    return std::max(ApplyRecurringOccurrences(GetPendingRecurringOccurrences()), 0);
+}
+
+bool Database::BeginTransaction() {
+    auto stmt = mStatements.Acquire(StatementId::BEGIN_TRANSACTION);
+    return stmt && stmt.Step() == SQLITE_DONE;
+}
+
+bool Database::CommitTransaction() {
+    auto stmt = mStatements.Acquire(StatementId::COMMIT_TRANSACTION);
+    if (!stmt || stmt.Step() != SQLITE_DONE) {
+        std::cerr << "Erreur lors du COMMIT: " << sqlite3_errmsg(mDb) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Database::RollbackTransaction() {
+    // Sans effet si SQLite a déjà annulé la transaction de lui-même
+    if (sqlite3_get_autocommit(mDb)) {
+        return;
+    }
+    auto stmt = mStatements.Acquire(StatementId::ROLLBACK_TRANSACTION);
+    if (stmt) {
+        stmt.Step();
+    }
+}
+
+ImportResult Database::BulkInsertTransactions(const std::vector<Transaction>& transactions,
+                                              const BulkInsertOptions& options) {
+    ImportResult result;
+    const size_t total = transactions.size();
+    const size_t chunkSize = std::max<size_t>(options.mChunkSize, 1);
+
+    // Si l'appelant a déjà ouvert une transaction, on s'y joint
+    const bool ownsTransaction = sqlite3_get_autocommit(mDb) != 0;
+    bool inTransaction = false;
+    int committedCount = 0;
+
+    auto stmt = mStatements.Acquire(StatementId::INSERT_TRANSACTION);
+    if (!stmt) {
+        result.mErrorCount = static_cast<int>(total);
+        result.mRolledBack = true;
+        return result;
+    }
+
+    for (size_t chunkStart = 0; chunkStart < total; chunkStart += chunkSize) {
+        const size_t chunkEnd = std::min(chunkStart + chunkSize, total);
+
+        if (ownsTransaction && !inTransaction) {
+            if (!BeginTransaction()) {
+                result.mRolledBack = true;
+                break;
+            }
+            inTransaction = true;
+        }
+
+        bool failed = chunkStart == 0 && options.mOnBegin && !options.mOnBegin();
+        for (size_t row = chunkStart; row < chunkEnd && !failed; ++row) {
+            BindTransaction(stmt, transactions[row]);
+            int rc = stmt.Step();
+            stmt.Reset();
+
+            if (rc == SQLITE_DONE) {
+                result.mSuccessCount++;
+            } else if (rc == SQLITE_CONSTRAINT) {
+                // Ligne refusée par le schéma : on l'écarte sans interrompre l'importation
+                result.mErrorCount++;
+                result.mErrors.push_back({row, sqlite3_errmsg(mDb)});
+            } else {
+                result.mErrorCount++;
+                result.mErrors.push_back({row, sqlite3_errmsg(mDb)});
+                failed = true;
+                break;
+            }
+        }
+
+        bool cancelled = !failed && options.mOnProgress && !options.mOnProgress(chunkEnd, total);
+
+        if (failed || cancelled) {
+            if (inTransaction) {
+                RollbackTransaction();
+                inTransaction = false;
+            }
+            result.mRolledBack = true;
+            break;
+        }
+
+        if (inTransaction && !options.mAtomic) {
+            if (!CommitTransaction()) {
+                RollbackTransaction();
+                result.mRolledBack = true;
+                inTransaction = false;
+                break;
+            }
+            inTransaction = false;
+            committedCount = result.mSuccessCount;
+        }
+    }
+
+    if (inTransaction) {
+        if (CommitTransaction()) {
+            committedCount = result.mSuccessCount;
+        } else {
+            RollbackTransaction();
+            result.mRolledBack = true;
+        }
+    } else if (!ownsTransaction && !result.mRolledBack) {
+        committedCount = result.mSuccessCount;
+    }
 
-    for (const auto& row : csvData) {
+    // Les lignes annulées ou non traitées ne comptent pas comme importées
+    if (result.mRolledBack) {
+        result.mSuccessCount = committedCount;
+        result.mErrorCount = static_cast<int>(total) - committedCount;
+    }
+
+    return result;
+}
+
+ImportResult Database::ImportTransactionsFromCSV(const std::vector<std::vector<std::string>>& csvData,
+                                                 int dateColumn, int libelleColumn, int sommeColumn,
+                                                 int typeColumn, const std::string& defaultType,
+                                                 bool pointeeByDefault,
+                                                 const BulkInsertOptions& options) {
+    ImportResult parseResult;
+    std::vector<Transaction> transactions;
+    std::vector<size_t> sourceRows;
+    transactions.reserve(csvData.size());
+    sourceRows.reserve(csvData.size());
+    // Types inconnus, avec les index des transactions qui les utilisent
+    std::map<std::string, std::vector<size_t>> newTypes;
+
+    for (size_t rowIndex = 0; rowIndex < csvData.size(); ++rowIndex) {
+        const auto& row = csvData[rowIndex];
         if (dateColumn >= (int)row.size() || libelleColumn >= (int)row.size() || sommeColumn >= (int)row.size()) {
-            errorCount++;
+            parseResult.mErrorCount++;
+            parseResult.mErrors.push_back({rowIndex, "Colonnes manquantes"});
             continue;
         }
 
@@ -664,7 +2591,8 @@ bool Database::ImportTransactionsFromCSV(const std::vector<std::vector<std::stri
                 !date.ParseFormat(dateStr, "%d/%m/%Y") &&
                 !date.ParseFormat(dateStr, "%d-%m-%Y") &&
                 !date.ParseFormat(dateStr, "%Y/%m/%d")) {
-                errorCount++;
+                parseResult.mErrorCount++;
+                parseResult.mErrors.push_back({rowIndex, "Date invalide : " + row[dateColumn]});
                 continue;
             }
             trans.SetDate(date);
@@ -672,62 +2600,105 @@ bool Database::ImportTransactionsFromCSV(const std::vector<std::vector<std::stri
             // Libellé
             trans.SetLibelle(row[libelleColumn]);
 
-            // Somme - gérer virgule et point
-            std::string sommeStr = row[sommeColumn];
-            std::replace(sommeStr.begin(), sommeStr.end(), ',', '.');
-
-            // Supprimer les espaces
-            sommeStr.erase(std::remove_if(sommeStr.begin(), sommeStr.end(), ::isspace), sommeStr.end());
-
-            double somme = 0.0;
-            try {
-                somme = std::stod(sommeStr);
-            } catch (...) {
-                errorCount++;
+            // Somme - virgule ou point, séparateurs de milliers, lue directement en centimes
+            auto somme = Money::Parse(row[sommeColumn]);
+            if (!somme) {
+                parseResult.mErrorCount++;
+                parseResult.mErrors.push_back({rowIndex, "Montant invalide : " + row[sommeColumn]});
                 continue;
             }
-            trans.SetSomme(std::abs(somme)); // Prendre la valeur absolue
+            trans.SetSomme(somme->Abs()); // Prendre la valeur absolue
 
-            // Type
+            // Type : un nom inconnu sera ajouté à la table types comme dépense
             std::string type = defaultType;
             if (typeColumn >= 0 && typeColumn < (int)row.size() && !row[typeColumn].empty()) {
                 type = row[typeColumn];
             }
-            trans.SetType(type);
+            if (type.empty()) {
+                parseResult.mErrorCount++;
+                parseResult.mErrors.push_back({rowIndex, "Type invalide : " + type});
+                continue;
+            }
+            if (mTypes.Contains(type)) {
+                trans.SetTypeId(mTypes.GetId(type));
+            } else {
+                newTypes[type].push_back(transactions.size());
+            }
 
             // Pointée
             trans.SetPointee(pointeeByDefault);
 
-            if (AddTransaction(trans)) {
-                successCount++;
-            } else {
-                errorCount++;
-            }
+            transactions.push_back(trans);
+            sourceRows.push_back(rowIndex);
         } catch (...) {
-            errorCount++;
+            parseResult.mErrorCount++;
+            parseResult.mErrors.push_back({rowIndex, "Ligne invalide"});
+        }
+    }
+
+    // Les types sont créés avec le premier bloc : une importation annulée
+    // ou en échec ne laisse aucun type derrière elle
+    BulkInsertOptions importOptions = options;
+    importOptions.mOnBegin = [this, &newTypes, &transactions]() {
+        auto stmt = mStatements.Acquire(StatementId::INSERT_TYPE);
+        if (!stmt) {
+            return false;
         }
+        for (const auto& [type, rows] : newTypes) {
+            stmt.BindAll(type, true);
+            const int rc = stmt.Step();
+            stmt.Reset();
+            if (rc != SQLITE_DONE) {
+                std::cerr << "Erreur création du type " << type << ": " << sqlite3_errmsg(mDb) << std::endl;
+                return false;
+            }
+            const int typeId = static_cast<int>(sqlite3_last_insert_rowid(mDb));
+            for (size_t index : rows) {
+                transactions[index].SetTypeId(typeId);
+            }
+        }
+        return true;
+    };
+
+    ImportResult result;
+    {
+        ScopedConnectionProfile bulkProfile(*this, ConnectionProfile::BulkLoad(mProfile));
+        result = BulkInsertTransactions(transactions, importOptions);
+    }
+
+    // Ramener les erreurs d'insertion aux numéros de ligne du CSV
+    for (auto& error : result.mErrors) {
+        error.mRow = sourceRows[error.mRow];
     }
+    result.mErrorCount += parseResult.mErrorCount;
+    result.mErrors.insert(result.mErrors.end(), parseResult.mErrors.begin(), parseResult.mErrors.end());
+    std::sort(result.mErrors.begin(), result.mErrors.end(),
+              [](const ImportRowError& a, const ImportRowError& b) { return a.mRow < b.mRow; });
 
-    return errorCount == 0;
+    return result;
 }
 
-bool Database::IsTypeUsed(const std::string& typeName) const {
-    // Example implementation - adjust based on your database structure
-    const char* sql = "SELECT COUNT(*) FROM transactions WHERE type_name = ?";
-    sqlite3_stmt* stmt;
+ScopedConnectionProfile::ScopedConnectionProfile(Database& database, const ConnectionProfile& profile)
+    : mDatabase(database), mPrevious(database.GetActiveProfile()) {
+    mDatabase.ApplyProfile(profile);
+}
+
+ScopedConnectionProfile::~ScopedConnectionProfile() {
+    mDatabase.ApplyProfile(mPrevious);
+    mDatabase.Checkpoint();
+}
 
-    if (sqlite3_prepare_v2(mDb, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+bool Database::IsTypeUsed(const std::string& typeName) const {
+    const int typeId = mTypes.GetId(typeName);
+    if (typeId < 0) {
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, typeName.c_str(), -1, SQLITE_TRANSIENT);
-
-    bool isUsed = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int count = sqlite3_column_int(stmt, 0);
-        isUsed = (count > 0);
+    auto stmt = mStatements.Acquire(StatementId::TYPE_IN_USE);
+    if (!stmt) {
+        return false;
     }
 
-    sqlite3_finalize(stmt);
-    return isUsed;
+    stmt.BindAll(typeId, typeId);
+    return stmt.Step() == SQLITE_ROW && stmt.Column<bool>(0);
 }
\ No newline at end of file
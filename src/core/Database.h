@@ -5,55 +5,353 @@
 #ifndef DATABASE_H
 #define DATABASE_H
 
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 #include <sqlite3.h>
 #include "Transaction.h"
 #include "RecurringTransaction.h"
+#include "StatementRegistry.h"
+#include "ChangeLog.h"
+#include "ConnectionProfile.h"
+#include "ReaderPool.h"
+#include "SqlProfiler.h"
+#include "TypeRegistry.h"
+#include "WriteBehindQueue.h"
 
-// Structure pour représenter un type avec son attribut
-struct TransactionType {
-    std::string mNom;
-    bool mIsDepense;  // true = dépense, false = recette
-    
-    TransactionType(const std::string& nom, bool isDepense)
-        : mNom(nom), mIsDepense(isDepense) {}
+// Résultat de la reconstruction de la table balances
+struct BalanceReport {
+    Money mStoredRestant;     // Valeurs maintenues par les triggers
+    Money mStoredPointee;
+    Money mComputedRestant;   // Valeurs recalculées depuis les transactions
+    Money mComputedPointee;
+
+    Money GetRestantDrift() const { return mStoredRestant - mComputedRestant; }
+    Money GetPointeeDrift() const { return mStoredPointee - mComputedPointee; }
+    bool HasDrift() const { return !GetRestantDrift().IsZero() || !GetPointeeDrift().IsZero(); }
+};
+
+// Erreur rencontrée sur une ligne lors d'une importation
+struct ImportRowError {
+    size_t mRow;          // Index de la ligne dans les données sources
+    std::string mMessage;
+};
+
+// Bilan d'une insertion en masse
+struct ImportResult {
+    int mSuccessCount = 0;
+    int mErrorCount = 0;
+    bool mRolledBack = false;  // true si l'importation a été annulée en base
+    std::vector<ImportRowError> mErrors;
+
+    bool IsSuccess() const { return mErrorCount == 0 && !mRolledBack; }
+};
+
+// Paramètres de l'insertion en masse
+struct BulkInsertOptions {
+    // Nombre de lignes entre deux rapports de progression (et deux COMMIT si non atomique)
+    size_t mChunkSize = 500;
+    // true : une seule transaction, tout est annulé en cas d'échec
+    // false : un BEGIN/COMMIT par bloc, seul le bloc en échec est annulé
+    bool mAtomic = true;
+    // Appelé après chaque bloc (lignes traitées, total) ; retourner false annule l'importation
+    std::function<bool(size_t, size_t)> mOnProgress;
+    // Appelé dans la transaction du premier bloc, avant sa première ligne ;
+    // retourner false annule l'importation
+    std::function<bool()> mOnBegin;
+};
+
+// Colonnes de tri d'une page de transactions (ordre des colonnes de la liste)
+enum class TransactionSortKey {
+    DATE,
+    LIBELLE,
+    SOMME,
+    POINTEE,       // Non pointées d'abord, puis par date
+    DATE_POINTEE,  // Sans date de pointage en dernier, puis par date
+    TYPE,
+    ID
+};
+
+// Filtres appliqués en base avant la pagination
+struct TransactionFilter {
+    bool mHidePointees = false;
+    std::string mLibelle;              // Sous-chaîne du libellé (insensible à la casse ASCII)
+    std::optional<int> mTypeId;
+    wxDateTime mFrom;                  // Bornes de date incluses, ignorées si invalides
+    wxDateTime mTo;
+};
+
+// Position de lecture : valeurs de tri et id de la dernière ligne renvoyée.
+// Un curseur vide désigne le début de la liste.
+struct PageCursor {
+    std::vector<std::variant<int64_t, std::string>> mKeys;
+    int mId = 0;
+
+    bool IsStart() const { return mKeys.empty() && mId == 0; }
+};
+
+// Effet d'une modification ciblée : la ligne avant et après, et la
+// variation des totaux (même règle que les triggers de la table balances)
+struct TransactionDelta {
+    Transaction mBefore;
+    Transaction mAfter;
+    Money mRestantDelta;
+    Money mPointeeDelta;
+};
+
+// Parcours complet : tri et filtres, sans pagination
+struct TransactionQuery {
+    TransactionSortKey mSortKey = TransactionSortKey::DATE;
+    bool mAscending = true;
+    TransactionFilter mFilter;
+};
+
+// Vue sur la ligne courante d'un parcours. Les textes pointent dans les tampons
+// de SQLite : ils ne sont valides que pendant l'appel du visiteur.
+struct TransactionRow {
+    int mId = 0;
+    int mDate = 0;                       // Numéro de jour (voir DayNumber)
+    std::string_view mLibelle;
+    Money mSomme;
+    bool mPointee = false;
+    int mTypeId = -1;
+    std::optional<int> mDatePointee;
+};
+
+// Périodes et regroupements des agrégats (GetRollup)
+enum class RollupGranularity {
+    MONTH,
+    QUARTER,
+    YEAR
+};
+
+enum class RollupGroupBy {
+    NONE,
+    TYPE
+};
+
+// Recettes et dépenses d'une période, et d'un type si regroupé par type
+struct RollupRow {
+    int mYear = 0;
+    int mPeriod = 0;      // Mois (1-12), trimestre (1-4), 0 pour une année
+    int mTypeId = -1;     // -1 sans regroupement par type
+    Money mRecettes;
+    Money mDepenses;      // Montant positif
+    int mCount = 0;
+
+    Money GetSolde() const { return mRecettes - mDepenses; }
+};
+
+// Échéance due d'une transaction récurrente : la transaction à créer, datée
+// du jour d'échéance
+struct RecurringOccurrence {
+    int mRecurringId;
+    Transaction mTransaction;
+};
+
+struct TransactionPage {
+    std::vector<Transaction> mTransactions;
+    PageCursor mNext;       // À passer à l'appel suivant
+    bool mHasMore = false;  // false sur la dernière page
+};
+
+// Lecture cohérente pour les exports et rapports : toutes les requêtes d'un
+// instantané voient la base telle qu'à son ouverture, même si des écritures
+// sont faites entre-temps sur la connexion principale. La connexion est
+// rendue au pool à la destruction.
+class ReadSnapshot {
+public:
+    ReadSnapshot() = default;
+    ~ReadSnapshot();
+
+    ReadSnapshot(ReadSnapshot&& other) noexcept;
+    ReadSnapshot& operator=(ReadSnapshot&& other) noexcept;
+    ReadSnapshot(const ReadSnapshot&) = delete;
+    ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+
+    explicit operator bool() const { return mDb != nullptr; }
+
+    // Mêmes contrats que les méthodes de Database, sans pointages en attente
+    size_t ForEachTransaction(const TransactionQuery& query,
+                              const std::function<bool(const TransactionRow&)>& visitor);
+    int GetTransactionCount();
+    Money GetTotalRestant();
+    Money GetTotalPointee();
+
+    static constexpr int kBackupPagesPerStep = 256;
+
+    // Copie page par page de l'instantané dans destPath (remplacé s'il existe)
+    // avec sqlite3_backup : le fichier obtenu est une base complète, ouvrable
+    // telle quelle. progress(restantes, total) est appelé après chaque étape
+    // de pagesPerStep pages ; s'il retourne false la copie est abandonnée et
+    // le fichier supprimé.
+    bool BackupTo(const std::string& destPath, int pagesPerStep = kBackupPagesPerStep,
+                  const std::function<bool(int, int)>& progress = nullptr);
+
+private:
+    friend class Database;
+    ReadSnapshot(sqlite3* db, StatementRegistry* statements,
+                 ReaderPool* pool, ReaderConnection* connection);
+    void Release();
+
+    sqlite3* mDb = nullptr;
+    StatementRegistry* mStatements = nullptr;
+    ReaderPool* mPool = nullptr;               // nullptr : connexion d'écriture
+    ReaderConnection* mConnection = nullptr;
 };
 
 class Database {
 public:
-    Database(const std::string& dbPath);
+    Database(const std::string& dbPath,
+             const ConnectionProfile& profile = ConnectionProfile::Interactive());
     ~Database();
 
     bool Open();
     void Close();
     bool IsOpen() const { return mDb != nullptr; }
+    const std::string& GetPath() const { return mDbPath; }
+
+    // Profil de connexion : celui configuré et celui réellement appliqué
+    bool ApplyProfile(const ConnectionProfile& profile);
+    const ConnectionProfile& GetProfile() const { return mProfile; }
+    const ConnectionProfile& GetActiveProfile() const { return mActiveProfile; }
+    std::string GetConnectionInfo();
+
+    // Recopie le journal WAL dans la base (sans effet hors mode WAL)
+    void Checkpoint();
 
     // Opérations sur les transactions
     bool AddTransaction(const Transaction& transaction);
     bool UpdateTransaction(const Transaction& transaction);
     bool DeleteTransaction(int id);
     std::vector<Transaction> GetAllTransactions();
+    // Transactions dont la date est comprise entre from et to (inclus)
+    std::vector<Transaction> GetTransactionsBetween(const wxDateTime& from, const wxDateTime& to);
     Transaction GetTransaction(int id);
 
+    // Modification d'un seul champ par id, sans relire ni réécrire toute la ligne.
+    // Rien si aucune transaction ne porte cet id ou en cas d'erreur.
+    std::optional<TransactionDelta> SetPointee(int id, bool pointee,
+                                               const wxDateTime& datePointee = wxDateTime::Today());
+    std::optional<TransactionDelta> SetType(int id, int typeId);
+    std::optional<TransactionDelta> SetAmount(int id, Money somme);
+
+    // Pointage différé (rapprochement) : visible tout de suite par GetTransaction
+    // et GetTotalPointee, écrit par FlushPendingWrites. Les lectures de listes
+    // et les autres modifications écrivent d'abord les pointages en attente.
+    std::optional<TransactionDelta> QueuePointee(int id, bool pointee,
+                                                 const wxDateTime& datePointee = wxDateTime::Today());
+    // Écrit les pointages en attente en une seule transaction SQL
+    bool FlushPendingWrites();
+    bool HasPendingWrites() const { return !mPendingWrites.IsEmpty(); }
+
+    // Pagination par clé (seek) : chaque page reprend après le curseur au lieu
+    // d'un OFFSET, son coût ne dépend pas de sa position dans la liste.
+    // La liste principale n'en lit que sa première page : elle garde ensuite
+    // toutes les transactions en mémoire (voir MainFrame::LoadTransactions).
+    TransactionPage GetTransactionsPage(TransactionSortKey sortKey, bool ascending,
+                                        const PageCursor& cursor, size_t limit,
+                                        const TransactionFilter& filter = TransactionFilter());
+
+    // Recherche dans les libellés (index FTS5 trigramme) : chaque mot de la
+    // requête doit apparaître dans le libellé, n'importe où et sans tenir
+    // compte de la casse. Ids classés par pertinence ; limit 0 : sans limite.
+    // Les mots plus courts que kMinSearchWordLength ne sont pas dans l'index :
+    // ils sont ignorés, l'appelant les compare lui-même aux libellés (LIKE ne
+    // replie que la casse ASCII). Vide si aucun mot n'est assez long.
+    static constexpr size_t kMinSearchWordLength = 3;
+    std::vector<int> SearchTransactions(const std::string& query, size_t limit);
+
+    // Parcourt les transactions sans les copier ; le visiteur retourne false
+    // pour arrêter le parcours. Retourne le nombre de lignes visitées.
+    size_t ForEachTransaction(const TransactionQuery& query,
+                              const std::function<bool(const TransactionRow&)>& visitor);
+
+    // Instantané de lecture sur une connexion du pool, utilisable depuis un
+    // autre thread que celui de la base ; il ne voit que les données validées
+    // (appeler FlushPendingWrites avant pour y inclure les pointages en attente).
+    // Sans pool (hors mode WAL) ou si toutes ses connexions sont prêtées, il
+    // utilise la connexion d'écriture et reste réservé au thread de la base.
+    ReadSnapshot OpenSnapshot();
+    // Instantané sur une connexion du pool, en attendant qu'une se libère :
+    // pour les threads autres que celui de la base. Vide sans pool.
+    ReadSnapshot OpenReaderSnapshot();
+    bool HasReaderPool() const { return mReaders.IsOpen(); }
+
+    // Suivi des modifications : la version augmente à chaque validation qui
+    // touche les transactions (sqlite3_update_hook) ou quand un autre
+    // processus modifie la base (PRAGMA data_version, tout est alors à relire)
+    uint64_t GetDataVersion();
+    ChangeSet GetChangesSince(uint64_t version);
+
     // Opérations sur les types
     bool AddType(const std::string& type, bool isDepense);
     bool UpdateType(const std::string& type, bool isDepense);
+    // Les transactions ne portent que l'id du type : seul le nom change
+    bool RenameType(const std::string& type, const std::string& newName);
+    // Échoue si le type est utilisé (clé étrangère)
     bool DeleteType(const std::string& type);
     std::vector<TransactionType> GetAllTypes();
-    bool IsTypeDepense(const std::string& type);
+    // Relit les types en mémoire, après une importation qui en a créé
+    void ReloadTypes();
+    bool IsTypeDepense(std::string_view type) const { return mTypes.IsDepense(type); }
+    bool IsTypeDepense(int typeId) const { return mTypes.IsDepense(typeId); }
+    // Types chargés en mémoire, à utiliser par l'interface plutôt que GetAllTypes()
+    const TypeRegistry& GetTypeRegistry() const { return mTypes; }
 
     // Statistiques
-    double GetTotalRestant();
-    double GetTotalPointee();
+    Money GetTotalRestant();
+    Money GetTotalPointee();
     int GetTransactionCount();
+
+    // Recettes et dépenses par période (et par type), triées par période puis
+    // par type. Les bornes sont étendues aux mois entiers ; une date invalide
+    // laisse l'intervalle ouvert. Lues dans la table rollup_monthly, dont
+    // seuls les mois modifiés depuis le dernier appel sont recalculés.
+    std::vector<RollupRow> GetRollup(RollupGranularity granularity, RollupGroupBy groupBy,
+                                     const wxDateTime& from = wxDateTime(),
+                                     const wxDateTime& to = wxDateTime());
+
+    // Solde après chaque transaction, dans l'ordre (date, id), par id. Lu dans
+    // la table running_balances : une modification ne recalcule que les
+    // transactions à partir de sa date, en repartant du point de contrôle
+    // mensuel précédent.
+    std::unordered_map<int, Money> GetRunningBalances();
+
+    // Recalcule la table balances depuis les transactions et signale tout écart
+    BalanceReport RebuildBalances();
     std::string GetDatabaseInfo();
 
-    // Importation CSV
-    bool ImportTransactionsFromCSV(const std::vector<std::vector<std::string>>& csvData,
-                                   int dateColumn, int libelleColumn, int sommeColumn,
-                                   int typeColumn, const std::string& defaultType,
-                                   bool pointeeByDefault);
+    // Nombre d'exécutions et temps cumulé (dans sqlite3_step) de chaque requête préparée
+    std::vector<StatementStats> GetStatementStats() const { return mStatements.GetStats(); }
+    void ResetStatementStats() { mStatements.ResetStats(); }
+
+    // Profil SQL (sqlite3_trace_v2) de toutes les requêtes exécutées, connexions
+    // de lecture comprises, regroupées par texte normalisé. Appelable depuis
+    // n'importe quel thread.
+    std::vector<SqlProfileEntry> GetSqlProfile() const { return mProfiler.GetEntries(); }
+    void ResetSqlProfile() { mProfiler.Reset(); }
+
+    // Plans d'exécution des requêtes enregistrées ; seules les étapes
+    // problématiques (parcours complet, tri temporaire) si onlyIssues
+    std::vector<QueryPlanStep> AuditQueryPlans(bool onlyIssues = true) const;
+
+    // Insertion en masse avec une seule requête préparée
+    ImportResult BulkInsertTransactions(const std::vector<Transaction>& transactions,
+                                        const BulkInsertOptions& options = BulkInsertOptions());
+
+    // Importation CSV. Les types inconnus sont créés (comme dépenses) dans la
+    // transaction de l'importation, sans toucher aux types en mémoire :
+    // appeler ReloadTypes par Call une fois l'importation terminée.
+    ImportResult ImportTransactionsFromCSV(const std::vector<std::vector<std::string>>& csvData,
+                                           int dateColumn, int libelleColumn, int sommeColumn,
+                                           int typeColumn, const std::string& defaultType,
+                                           bool pointeeByDefault,
+                                           const BulkInsertOptions& options = BulkInsertOptions());
 
     // Méthodes pour les transactions récurrentes
     bool AddRecurringTransaction(const RecurringTransaction& trans);
@@ -62,18 +360,115 @@ public:
     std::vector<RecurringTransaction> GetAllRecurringTransactions();
     RecurringTransaction GetRecurringTransaction(int id);
     
-    // Exécute les transactions récurrentes dues
+    // Échéances dues jusqu'à until pour toutes les récurrences, triées par date,
+    // sans rien écrire (aperçu avant validation)
+    std::vector<RecurringOccurrence> GetPendingRecurringOccurrences(const wxDateTime& until = wxDateTime::Today());
+    // Crée les transactions et avance last_executed en une seule transaction SQL.
+    // Les échéances déjà exécutées depuis l'aperçu sont ignorées.
+    // Retourne le nombre de transactions créées, -1 en cas d'échec (rien n'est écrit).
+    int ApplyRecurringOccurrences(const std::vector<RecurringOccurrence>& occurrences);
+    // Rattrape toutes les échéances dues jusqu'à aujourd'hui
     int ExecutePendingRecurringTransactions();
 
     bool IsTypeUsed(const std::string& typeName) const;
 
+    // Version du schéma (PRAGMA user_version)
+    int GetSchemaVersion();
+    // Version atteinte après toutes les migrations
+    static int GetLatestSchemaVersion();
+
 private:
     bool CreateTables();
+    bool InitializeBalances();
     bool InitializeDefaultTypes();
     void MigrateTypesTable();  // Pour migrer l'ancienne table si nécessaire
 
+    // Migrations versionnées (PRAGMA user_version) : chacune est appliquée une
+    // seule fois, dans l'ordre, dans sa propre transaction. Sur une base à
+    // jour, l'ouverture se limite à la lecture de la version.
+    struct Migration {
+        int mVersion;
+        const char* mName;
+        bool (Database::*mApply)();
+    };
+    static const Migration kMigrations[];
+    // Version du schéma créé directement pour une base neuve
+    static constexpr int kBaseSchemaVersion = 2;
+
+    bool TableExists(const char* table);
+    bool SetSchemaVersion(int version);
+    bool MigrateSchema();
+    bool ApplyMigration(const Migration& migration);
+    bool CreateBaseSchema();          // Base neuve : tables et types par défaut
+    bool MigrateDatesToDayNumbers();  // v1 : dates TEXT -> numéros de jour
+    bool MigrateAmountsToCents();     // v2 : montants REAL -> centimes INTEGER
+    bool CreateIndexes();             // v3
+    bool CreateBalanceTriggers();     // v4
+    bool CreateSearchIndex();         // v5
+    bool AddRecurringNextExecution(); // v6 : colonne next_execution_date indexée
+    bool MigrateTypesToForeignKey();  // v7 : type TEXT -> type_id INTEGER REFERENCES types
+    bool CreateRollupTables();        // v8 : agrégats mensuels par type
+    bool CreateRunningBalances();     // v9 : solde progressif et points de contrôle
+
+    // Transactions SQL explicites
+    bool BeginTransaction();
+    bool CommitTransaction();
+    void RollbackTransaction();
+    bool BindTransaction(ScopedStatement& stmt, const Transaction& transaction);
+    // Exécute une modification ciblée déjà liée et calcule son delta
+    std::optional<TransactionDelta> ApplyFieldUpdate(int id, ScopedStatement& stmt);
+    Money GetSignedAmount(const Transaction& transaction) const;
+    // Ligne telle qu'en base, sans les pointages en attente
+    Transaction ReadStoredTransaction(int id);
+    std::vector<RecurringTransaction> ReadRecurringRows(ScopedStatement& stmt);
+    // Recalcule les mois périmés de rollup_monthly compris entre deux clés de mois
+    bool RefreshRollup(int fromMonth, int toMonth);
+    // Recalcule running_balances et balance_checkpoints depuis la première
+    // date modifiée
+    bool RefreshRunningBalances();
+
+    bool ApplyPragmas(const ConnectionProfile& profile, bool includeJournalMode);
+
+    // Hooks SQLite alimentant mChanges
+    void InstallChangeHooks();
+    void CheckExternalChanges();
+    static void OnRowChanged(void* database, int operation, const char* dbName,
+                             const char* table, sqlite3_int64 rowId);
+    static int OnCommit(void* database);
+    static void OnRollback(void* database);
+    std::string QueryPragma(const char* pragma);
+
+    // Connexions en lecture seule : une pour le rapport en cours (le thread des
+    // rapports n'en emprunte qu'une à la fois), une pour les instantanés pris
+    // depuis le thread de la base
+    static constexpr size_t kReaderPoolSize = 2;
+
     std::string mDbPath;
     sqlite3* mDb;
+    mutable StatementRegistry mStatements;
+    ConnectionProfile mProfile;
+    ConnectionProfile mActiveProfile;
+    TypeRegistry mTypes;
+    WriteBehindQueue mPendingWrites;
+    SqlProfiler mProfiler;  // Déclaré avant mReaders, qui s'en détachent à leur fermeture
+    ReaderPool mReaders;
+    ChangeLog mChanges;
+    int64_t mDataVersion = -1;  // Dernière valeur de PRAGMA data_version
+};
+
+// Bascule temporairement la connexion sur un autre profil (ex. BulkLoad)
+// et restaure le profil précédent à la destruction
+class ScopedConnectionProfile {
+public:
+    ScopedConnectionProfile(Database& database, const ConnectionProfile& profile);
+    ~ScopedConnectionProfile();
+
+    ScopedConnectionProfile(const ScopedConnectionProfile&) = delete;
+    ScopedConnectionProfile& operator=(const ScopedConnectionProfile&) = delete;
+
+private:
+    Database& mDatabase;
+    ConnectionProfile mPrevious;
 };
 
 #endif // DATABASE_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "DayNumber.h"
+
+namespace DayNumber {
+
+namespace {
+
+// Lit exactement count chiffres à partir de pos
+bool ReadDigits(std::string_view text, size_t pos, size_t count, int& value) {
+    if (pos + count > text.size()) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+std::optional<int> MakeDay(int year, int month, int day) {
+    if (!IsValidCivil(year, month, day)) {
+        return std::nullopt;
+    }
+    return FromCivil(year, month, day);
+}
+
+} // namespace
+
+std::optional<int> FromDateTime(const wxDateTime& date) {
+    if (!date.IsValid()) {
+        return std::nullopt;
+    }
+    return FromCivil(date.GetYear(), static_cast<int>(date.GetMonth()) + 1, date.GetDay());
+}
+
+wxDateTime ToDateTime(int dayNumber) {
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    ToCivil(dayNumber, year, month, day);
+    return wxDateTime(static_cast<wxDateTime::wxDateTime_t>(day),
+                      static_cast<wxDateTime::Month>(month - 1), year);
+}
+
+std::optional<int> ParseLegacy(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+
+    int year = 0;
+    int month = 0;
+    int day = 0;
+
+    // Format écrit par les versions précédentes : AAAA-MM-JJ[ HH:MM:SS]
+    if (ReadDigits(text, 0, 4, year) && text.size() >= 10 &&
+        (text[4] == '-' || text[4] == '/') && text[7] == text[4] &&
+        ReadDigits(text, 5, 2, month) && ReadDigits(text, 8, 2, day)) {
+        if (text.size() > 10 && text[10] != ' ' && text[10] != 'T') {
+            return std::nullopt;
+        }
+        return MakeDay(year, month, day);
+    }
+
+    // Saisie à la française : JJ/MM/AAAA
+    if (text.size() >= 10 && text[2] == '/' && text[5] == '/' &&
+        ReadDigits(text, 0, 2, day) && ReadDigits(text, 3, 2, month) && ReadDigits(text, 6, 4, year)) {
+        if (text.size() > 10 && text[10] != ' ') {
+            return std::nullopt;
+        }
+        return MakeDay(year, month, day);
+    }
+
+    return std::nullopt;
+}
+
+} // namespace DayNumber
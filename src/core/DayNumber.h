@@ -0,0 +1,66 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef DAYNUMBER_H
+#define DAYNUMBER_H
+
+#include <optional>
+#include <string_view>
+#include <wx/datetime.h>
+
+// Dates stockées en base sous forme de numéro de jour : nombre de jours
+// depuis le 1970-01-01 (calendrier grégorien). Les comparaisons et les
+// intervalles deviennent de simples comparaisons d'entiers.
+namespace DayNumber {
+
+constexpr bool IsLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+constexpr int DaysInMonth(int year, int month) {
+    constexpr int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && IsLeapYear(year) ? 29 : kDays[month - 1];
+}
+
+constexpr bool IsValidCivil(int year, int month, int day) {
+    return month >= 1 && month <= 12 && day >= 1 && day <= DaysInMonth(year, month);
+}
+
+// Conversion jour/mois/année -> numéro de jour (algorithme de H. Hinnant)
+constexpr int FromCivil(int year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Conversion inverse, mois et jour à partir de 1
+constexpr void ToCivil(int dayNumber, int& year, int& month, int& day) {
+    dayNumber += 719468;
+    const int era = (dayNumber >= 0 ? dayNumber : dayNumber - 146096) / 146097;
+    const int dayOfEra = dayNumber - era * 146097;
+    const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+static_assert(FromCivil(1970, 1, 1) == 0, "Origine des numéros de jour");
+static_assert(FromCivil(2000, 3, 1) == 11017, "Calcul des années bissextiles");
+
+// Numéro de jour d'une date, ou rien si la date est invalide
+std::optional<int> FromDateTime(const wxDateTime& date);
+wxDateTime ToDateTime(int dayNumber);
+
+// Lecture des dates texte des anciennes bases ("AAAA-MM-JJ", éventuellement
+// suivie d'une heure, ou "JJ/MM/AAAA"), sans passer par wxDateTime
+std::optional<int> ParseLegacy(std::string_view text);
+
+} // namespace DayNumber
+
+#endif // DAYNUMBER_H
@@ -0,0 +1,148 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "Money.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Espaces ignorés dans un montant : espace, tabulation, espaces insécables UTF-8
+size_t SkippableLength(std::string_view text, size_t pos) {
+    if (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\'') {
+        return 1;
+    }
+    if (text.compare(pos, 2, "\xC2\xA0") == 0) {
+        return 2;
+    }
+    if (text.compare(pos, 3, "\xE2\x80\xAF") == 0) {
+        return 3;
+    }
+    return 0;
+}
+
+} // namespace
+
+Money Money::FromDouble(double amount) {
+    return Money(static_cast<int64_t>(std::llround(amount * 100.0)));
+}
+
+std::optional<Money> Money::Parse(std::string_view text) {
+    // Symbole euro éventuel en fin de chaîne
+    constexpr std::string_view kEuro = "\xE2\x82\xAC";
+
+    std::string compact;
+    compact.reserve(text.size());
+    for (size_t pos = 0; pos < text.size();) {
+        if (size_t skip = SkippableLength(text, pos)) {
+            pos += skip;
+        } else if (text.compare(pos, kEuro.size(), kEuro) == 0) {
+            pos += kEuro.size();
+        } else {
+            compact += text[pos++];
+        }
+    }
+
+    bool negative = false;
+    size_t pos = 0;
+    if (!compact.empty() && (compact[0] == '-' || compact[0] == '+')) {
+        negative = compact[0] == '-';
+        pos = 1;
+    }
+
+    // Le dernier séparateur est décimal, sauf s'il est répété (séparateur de milliers)
+    const size_t lastComma = compact.rfind(',');
+    const size_t lastPoint = compact.rfind('.');
+    size_t decimalPos = std::string::npos;
+    if (lastComma != std::string::npos && lastPoint != std::string::npos) {
+        decimalPos = std::max(lastComma, lastPoint);
+    } else if (lastComma != std::string::npos) {
+        decimalPos = compact.find(',') == lastComma ? lastComma : std::string::npos;
+    } else if (lastPoint != std::string::npos) {
+        decimalPos = compact.find('.') == lastPoint ? lastPoint : std::string::npos;
+    }
+
+    int64_t units = 0;
+    int64_t cents = 0;
+    int digits = 0;
+    int decimals = 0;
+    bool roundUp = false;
+
+    for (; pos < compact.size(); ++pos) {
+        const char c = compact[pos];
+        if (pos == decimalPos) {
+            continue;
+        }
+        if (c == ',' || c == '.') {
+            // Séparateur de milliers : interdit dans la partie décimale
+            if (decimalPos != std::string::npos && pos > decimalPos) {
+                return std::nullopt;
+            }
+            // ... et toujours suivi d'un groupe de trois chiffres
+            for (size_t i = pos + 1; i <= pos + 3; ++i) {
+                if (i >= compact.size() || compact[i] < '0' || compact[i] > '9') {
+                    return std::nullopt;
+                }
+            }
+            if (pos + 4 < compact.size() && compact[pos + 4] >= '0' && compact[pos + 4] <= '9') {
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+
+        if (decimalPos == std::string::npos || pos < decimalPos) {
+            // Au-delà, le montant ne tient plus sur un int64 en centimes
+            if (++digits > 15) {
+                return std::nullopt;
+            }
+            units = units * 10 + (c - '0');
+        } else if (decimals < 2) {
+            cents = cents * 10 + (c - '0');
+            ++decimals;
+        } else if (decimals++ == 2) {
+            roundUp = c >= '5';
+        }
+    }
+
+    if (digits == 0 && decimals == 0) {
+        return std::nullopt;
+    }
+
+    while (decimals < 2) {
+        cents *= 10;
+        ++decimals;
+    }
+
+    int64_t total = units * 100 + cents + (roundUp ? 1 : 0);
+    return Money(negative ? -total : total);
+}
+
+std::string Money::ToString() const {
+    return Format('.', "");
+}
+
+std::string Money::Format(char decimalSeparator, std::string_view groupSeparator) const {
+    // Valeur absolue calculée en non signé pour couvrir INT64_MIN
+    const uint64_t absolute = mCents < 0 ? 0 - static_cast<uint64_t>(mCents) : static_cast<uint64_t>(mCents);
+    const std::string units = std::to_string(absolute / 100);
+    const unsigned fraction = static_cast<unsigned>(absolute % 100);
+
+    std::string result;
+    if (mCents < 0) {
+        result += '-';
+    }
+    for (size_t i = 0; i < units.size(); ++i) {
+        if (i > 0 && (units.size() - i) % 3 == 0) {
+            result += groupSeparator;
+        }
+        result += units[i];
+    }
+    result += decimalSeparator;
+    result += static_cast<char>('0' + fraction / 10);
+    result += static_cast<char>('0' + fraction % 10);
+    return result;
+}
@@ -0,0 +1,56 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Montant en centimes (virgule fixe) : additions et totaux exacts,
+// sans les erreurs d'arrondi des double
+class Money {
+public:
+    constexpr Money() : mCents(0) {}
+
+    static constexpr Money FromCents(int64_t cents) { return Money(cents); }
+    // Arrondi au centime le plus proche (valeurs héritées, calculs en double)
+    static Money FromDouble(double amount);
+
+    // Accepte "1234.56", "-12,5", "1 234,56", "1.234,56", "+3 €"...
+    // Au-delà de deux décimales, le montant est arrondi au centime
+    static std::optional<Money> Parse(std::string_view text);
+
+    constexpr int64_t GetCents() const { return mCents; }
+    double ToDouble() const { return static_cast<double>(mCents) / 100.0; }
+
+    constexpr bool IsZero() const { return mCents == 0; }
+    constexpr bool IsNegative() const { return mCents < 0; }
+    constexpr Money Abs() const { return Money(mCents < 0 ? -mCents : mCents); }
+
+    constexpr Money operator-() const { return Money(-mCents); }
+    constexpr Money operator+(Money other) const { return Money(mCents + other.mCents); }
+    constexpr Money operator-(Money other) const { return Money(mCents - other.mCents); }
+    constexpr Money operator*(int64_t factor) const { return Money(mCents * factor); }
+    constexpr Money& operator+=(Money other) { mCents += other.mCents; return *this; }
+    constexpr Money& operator-=(Money other) { mCents -= other.mCents; return *this; }
+
+    constexpr bool operator==(const Money&) const = default;
+    constexpr auto operator<=>(const Money&) const = default;
+
+    // "-1234.56" : format d'échange (champs de saisie, fichiers)
+    std::string ToString() const;
+    // Format d'affichage, ex. Format(',', " ") -> "-1 234,56"
+    std::string Format(char decimalSeparator, std::string_view groupSeparator) const;
+
+private:
+    explicit constexpr Money(int64_t cents) : mCents(cents) {}
+
+    int64_t mCents;
+};
+
+#endif // MONEY_H
@@ -0,0 +1,62 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// File sans verrou à producteurs multiples et consommateur unique
+// (algorithme de D. Vyukov) : Push depuis n'importe quel thread,
+// Pop uniquement depuis le thread consommateur.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : mHead(new Node), mTail(mHead.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue() {
+        while (Pop()) {
+        }
+        delete mTail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void Push(T value) {
+        Node* node = new Node;
+        node->mValue.emplace(std::move(value));
+        Node* previous = mHead.exchange(node, std::memory_order_acq_rel);
+        previous->mNext.store(node, std::memory_order_release);
+    }
+
+    // Rien si la file est vide, ou si un producteur n'a pas encore
+    // fini de chaîner son élément (réessayer dans ce cas)
+    std::optional<T> Pop() {
+        Node* tail = mTail;
+        Node* next = tail->mNext.load(std::memory_order_acquire);
+        if (!next) {
+            return std::nullopt;
+        }
+
+        std::optional<T> value = std::move(next->mValue);
+        next->mValue.reset();
+        mTail = next;
+        delete tail;
+        return value;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> mNext{nullptr};
+        std::optional<T> mValue;
+    };
+
+    std::atomic<Node*> mHead;  // Dernier élément poussé (producteurs)
+    Node* mTail;               // Nœud sentinelle (consommateur)
+};
+
+#endif // MPSCQUEUE_H
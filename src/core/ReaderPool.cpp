@@ -0,0 +1,126 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "ReaderPool.h"
+#include <iostream>
+
+ReaderPool::~ReaderPool() {
+    Close();
+}
+
+bool ReaderPool::Open(const std::string& path, const ConnectionProfile& profile, size_t size,
+                      SqlProfiler* profiler) {
+    Close();
+
+    std::vector<std::unique_ptr<ReaderConnection>> connections;
+    for (size_t i = 0; i < size; ++i) {
+        auto connection = std::make_unique<ReaderConnection>();
+        if (!OpenConnection(*connection, path, profile)) {
+            for (auto& opened : connections) {
+                CloseConnection(*opened);
+            }
+            return false;
+        }
+        connections.push_back(std::move(connection));
+    }
+
+    if (profiler) {
+        for (auto& connection : connections) {
+            profiler->Attach(connection->mDb);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mProfiler = profiler;
+    mConnections = std::move(connections);
+    for (auto& connection : mConnections) {
+        mIdle.push_back(connection.get());
+    }
+    return true;
+}
+
+void ReaderPool::Close() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReleased.wait(lock, [this]() { return mIdle.size() == mConnections.size(); });
+
+    for (auto& connection : mConnections) {
+        if (mProfiler) {
+            mProfiler->Detach(connection->mDb);
+        }
+        CloseConnection(*connection);
+    }
+    mProfiler = nullptr;
+    mIdle.clear();
+    mConnections.clear();
+}
+
+ReaderConnection* ReaderPool::Acquire() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReleased.wait(lock, [this]() { return !mIdle.empty() || mConnections.empty(); });
+    if (mIdle.empty()) {
+        return nullptr;
+    }
+
+    ReaderConnection* connection = mIdle.back();
+    mIdle.pop_back();
+    return connection;
+}
+
+ReaderConnection* ReaderPool::TryAcquire() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mIdle.empty()) {
+        return nullptr;
+    }
+
+    ReaderConnection* connection = mIdle.back();
+    mIdle.pop_back();
+    return connection;
+}
+
+void ReaderPool::Release(ReaderConnection* connection) {
+    if (!connection) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIdle.push_back(connection);
+    }
+    mReleased.notify_all();
+}
+
+bool ReaderPool::OpenConnection(ReaderConnection& connection, const std::string& path,
+                                const ConnectionProfile& profile) {
+    int rc = sqlite3_open_v2(path.c_str(), &connection.mDb,
+                             SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Erreur ouverture connexion de lecture: "
+                  << (connection.mDb ? sqlite3_errmsg(connection.mDb) : sqlite3_errstr(rc)) << std::endl;
+        CloseConnection(connection);
+        return false;
+    }
+
+    sqlite3_busy_timeout(connection.mDb, profile.mBusyTimeoutMs);
+
+    // Le mode de journal et la durabilité appartiennent à la connexion d'écriture
+    for (const auto& pragma : profile.ToPragmas()) {
+        if (pragma.rfind("PRAGMA journal_mode", 0) == 0 || pragma.rfind("PRAGMA synchronous", 0) == 0) {
+            continue;
+        }
+        sqlite3_exec(connection.mDb, pragma.c_str(), nullptr, nullptr, nullptr);
+    }
+
+    if (!connection.mStatements.Prepare(connection.mDb)) {
+        CloseConnection(connection);
+        return false;
+    }
+    return true;
+}
+
+void ReaderPool::CloseConnection(ReaderConnection& connection) {
+    connection.mStatements.Finalize();
+    if (connection.mDb) {
+        sqlite3_close(connection.mDb);
+        connection.mDb = nullptr;
+    }
+}
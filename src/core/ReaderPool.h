@@ -0,0 +1,64 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef READERPOOL_H
+#define READERPOOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "ConnectionProfile.h"
+#include "SqlProfiler.h"
+#include "StatementRegistry.h"
+
+// Connexion en lecture seule et ses requêtes préparées
+struct ReaderConnection {
+    sqlite3* mDb = nullptr;
+    StatementRegistry mStatements;
+};
+
+// Petit pool de connexions en lecture seule ouvertes à côté de la connexion
+// d'écriture. En mode WAL, chacune lit un instantané cohérent de la base
+// sans bloquer l'écriture. Acquire/Release peuvent être appelés depuis
+// n'importe quel thread.
+class ReaderPool {
+public:
+    ReaderPool() = default;
+    ~ReaderPool();
+
+    ReaderPool(const ReaderPool&) = delete;
+    ReaderPool& operator=(const ReaderPool&) = delete;
+
+    // Ouvre size connexions sur la base (qui doit déjà exister), profilées
+    // par profiler s'il est fourni
+    bool Open(const std::string& path, const ConnectionProfile& profile, size_t size,
+              SqlProfiler* profiler = nullptr);
+    // Attend le retour des connexions prêtées puis les ferme
+    void Close();
+    bool IsOpen() const { return !mConnections.empty(); }
+    size_t GetSize() const { return mConnections.size(); }
+
+    // Emprunte une connexion libre, en attendant si toutes sont prêtées.
+    // nullptr si le pool est fermé.
+    ReaderConnection* Acquire();
+    // Comme Acquire, sans attendre : nullptr si toutes sont prêtées
+    ReaderConnection* TryAcquire();
+    void Release(ReaderConnection* connection);
+
+private:
+    static bool OpenConnection(ReaderConnection& connection, const std::string& path,
+                               const ConnectionProfile& profile);
+    static void CloseConnection(ReaderConnection& connection);
+
+    std::vector<std::unique_ptr<ReaderConnection>> mConnections;
+    std::vector<ReaderConnection*> mIdle;
+    std::mutex mMutex;
+    std::condition_variable mReleased;
+    SqlProfiler* mProfiler = nullptr;
+};
+
+#endif // READERPOOL_H
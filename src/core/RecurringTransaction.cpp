@@ -6,48 +6,60 @@
 #include <algorithm>
 
 RecurringTransaction::RecurringTransaction()
-    : mId(0), mLibelle(""), mSomme(0.0), mType(""),
+    : mId(0), mLibelle(""), mSomme(), mTypeId(-1),
       mRecurrence(RecurrenceType::MONTHLY), mDayOfMonth(1), mActive(true) {
 }
 
 RecurringTransaction::RecurringTransaction(int id, const std::string& libelle,
-                                          double somme, const std::string& type,
+                                          Money somme, int typeId,
                                           RecurrenceType recurrence,
                                           const wxDateTime& startDate,
                                           const wxDateTime& endDate,
                                           int dayOfMonth, bool active)
-    : mId(id), mLibelle(libelle), mSomme(somme), mType(type),
+    : mId(id), mLibelle(libelle), mSomme(somme), mTypeId(typeId),
       mRecurrence(recurrence), mStartDate(startDate), mEndDate(endDate),
       mDayOfMonth(dayOfMonth), mActive(active) {
 }
 
 wxDateTime RecurringTransaction::GetNextExecutionDate() const {
-    wxDateTime nextDate;
-
     if (!mLastExecuted.IsValid()) {
+        return mStartDate;
+    }
+    return Advance(mLastExecuted);
+}
+
+wxDateTime RecurringTransaction::GetNextPendingDate() const {
+    wxDateTime nextDate = GetNextExecutionDate();
+    if (nextDate.IsValid() && nextDate < mStartDate) {
         nextDate = mStartDate;
-    } else {
-        nextDate = mLastExecuted;
-
-        switch (mRecurrence) {
-            case RecurrenceType::DAILY:
-                nextDate.Add(wxDateSpan::Day());
-                break;
-
-            case RecurrenceType::WEEKLY:
-                nextDate.Add(wxDateSpan::Week());
-                break;
-
-            case RecurrenceType::MONTHLY:
-                nextDate.Add(wxDateSpan::Month());
-                nextDate.SetDay(std::min(mDayOfMonth,
-                            static_cast<int>(wxDateTime::GetNumberOfDays(nextDate.GetMonth(), nextDate.GetYear()))));
-                break;
-
-            case RecurrenceType::YEARLY:
-                nextDate.Add(wxDateSpan::Year());
-                break;
-        }
+    }
+    if (!nextDate.IsValid() || (mEndDate.IsValid() && mEndDate < nextDate)) {
+        return wxDateTime();
+    }
+    return nextDate;
+}
+
+wxDateTime RecurringTransaction::Advance(const wxDateTime& date) const {
+    wxDateTime nextDate = date;
+
+    switch (mRecurrence) {
+        case RecurrenceType::DAILY:
+            nextDate.Add(wxDateSpan::Day());
+            break;
+
+        case RecurrenceType::WEEKLY:
+            nextDate.Add(wxDateSpan::Week());
+            break;
+
+        case RecurrenceType::MONTHLY:
+            nextDate.Add(wxDateSpan::Month());
+            nextDate.SetDay(std::min(mDayOfMonth,
+                        static_cast<int>(wxDateTime::GetNumberOfDays(nextDate.GetMonth(), nextDate.GetYear()))));
+            break;
+
+        case RecurrenceType::YEARLY:
+            nextDate.Add(wxDateSpan::Year());
+            break;
     }
 
     return nextDate;
@@ -73,4 +85,31 @@ bool RecurringTransaction::ShouldExecuteToday() const {
 
     // Vérifier si on doit exécuter aujourd'hui
     return nextExec.IsSameDate(today) || nextExec < today;
+}
+
+std::vector<wxDateTime> RecurringTransaction::GetPendingOccurrences(const wxDateTime& until) const {
+    std::vector<wxDateTime> occurrences;
+    if (!mActive || !mStartDate.IsValid() || !until.IsValid()) {
+        return occurrences;
+    }
+
+    wxDateTime last = until;
+    if (mEndDate.IsValid() && mEndDate < last) {
+        last = mEndDate;
+    }
+
+    wxDateTime date = GetNextExecutionDate();
+    while (date.IsValid() && (date < last || date.IsSameDate(last))) {
+        if (!(date < mStartDate)) {
+            occurrences.push_back(date);
+        }
+
+        const wxDateTime next = Advance(date);
+        // Garde-fou : une date qui n'avance plus arrêterait la boucle
+        if (!(date < next)) {
+            break;
+        }
+        date = next;
+    }
+    return occurrences;
 }
\ No newline at end of file
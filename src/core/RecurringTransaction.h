@@ -6,7 +6,9 @@
 #define RECURRINGTRANSACTION_H
 
 #include <string>
+#include <vector>
 #include <wx/datetime.h>
+#include "Money.h"
 
 enum class RecurrenceType {
     DAILY,      // Quotidien
@@ -18,16 +20,16 @@ enum class RecurrenceType {
 class RecurringTransaction {
 public:
     RecurringTransaction();
-    RecurringTransaction(int id, const std::string& libelle, double somme,
-                        const std::string& type, RecurrenceType recurrence,
+    RecurringTransaction(int id, const std::string& libelle, Money somme,
+                        int typeId, RecurrenceType recurrence,
                         const wxDateTime& startDate, const wxDateTime& endDate,
                         int dayOfMonth = 1, bool active = true);
 
     // Getters
     int GetId() const { return mId; }
     std::string GetLibelle() const { return mLibelle; }
-    double GetSomme() const { return mSomme; }
-    std::string GetType() const { return mType; }
+    Money GetSomme() const { return mSomme; }
+    int GetTypeId() const { return mTypeId; }
     RecurrenceType GetRecurrence() const { return mRecurrence; }
     wxDateTime GetStartDate() const { return mStartDate; }
     wxDateTime GetEndDate() const { return mEndDate; }
@@ -38,8 +40,8 @@ public:
     // Setters
     void SetId(int id) { mId = id; }
     void SetLibelle(const std::string& libelle) { mLibelle = libelle; }
-    void SetSomme(double somme) { mSomme = somme; }
-    void SetType(const std::string& type) { mType = type; }
+    void SetSomme(Money somme) { mSomme = somme; }
+    void SetTypeId(int typeId) { mTypeId = typeId; }
     void SetRecurrence(RecurrenceType recurrence) { mRecurrence = recurrence; }
     void SetStartDate(const wxDateTime& date) { mStartDate = date; }
     void SetEndDate(const wxDateTime& date) { mEndDate = date; }
@@ -50,14 +52,25 @@ public:
     // Calcule la prochaine date d'exécution
     wxDateTime GetNextExecutionDate() const;
 
+    // Prochaine échéance à exécuter, invalide si la date de fin est dépassée
+    // (valeur de la colonne next_execution_date)
+    wxDateTime GetNextPendingDate() const;
+
     // Vérifie si la transaction doit être exécutée aujourd'hui
     bool ShouldExecuteToday() const;
 
+    // Toutes les échéances non encore exécutées jusqu'à until (inclus), à leur
+    // date réelle : une récurrence mensuelle oubliée trois mois en donne trois
+    std::vector<wxDateTime> GetPendingOccurrences(const wxDateTime& until) const;
+
 private:
+    // Échéance suivant date selon la périodicité
+    wxDateTime Advance(const wxDateTime& date) const;
+
     int mId;
     std::string mLibelle;
-    double mSomme;
-    std::string mType;
+    Money mSomme;
+    int mTypeId;  // Identifiant dans la table types
     RecurrenceType mRecurrence;
     wxDateTime mStartDate;
     wxDateTime mEndDate;  // Date de fin (peut être invalide pour illimité)
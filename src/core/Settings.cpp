@@ -4,10 +4,12 @@
 
 #include "Settings.h"
 #include <wx/stdpaths.h>
+#include <algorithm>
 
 Settings::Settings()
     : mDateFormat(FORMAT_DD_MM_YY),
-      mDecimalSeparator(SEPARATOR_COMMA) {
+      mDecimalSeparator(SEPARATOR_COMMA),
+      mDatabasePath("mescomptes.db") {
 
     wxString configPath = wxStandardPaths::Get().GetUserDataDir();
     if (!wxFileName::DirExists(configPath)) {
@@ -39,7 +41,30 @@ void Settings::SetDecimalSeparator(DecimalSeparator separator) {
     Save();
 }
 
+void Settings::SetDatabasePath(const std::string& path) {
+    mDatabasePath = path;
+    Save();
+}
+
+void Settings::SetConnectionProfile(const ConnectionProfile& profile) {
+    mConnectionProfile = profile;
+    Save();
+}
+
+void Settings::SetAccounts(const std::vector<Account>& accounts) {
+    mAccounts = accounts;
+    Save();
+}
+
 wxString Settings::FormatDate(const wxDateTime& date) const {
+    return GetDisplayFormat().FormatDate(date);
+}
+
+wxString Settings::FormatMoney(Money amount) const {
+    return GetDisplayFormat().FormatMoney(amount);
+}
+
+wxString Settings::DisplayFormat::FormatDate(const wxDateTime& date) const {
     if (!date.IsValid()) {
         return "";
     }
@@ -60,51 +85,35 @@ wxString Settings::FormatDate(const wxDateTime& date) const {
     }
 }
 
-wxString Settings::FormatMoney(double amount) const {
-    wxString formatted;
-
+wxString Settings::DisplayFormat::FormatMoney(Money amount) const {
     if (mDecimalSeparator == SEPARATOR_COMMA) {
         // Format français : 1 234,56
-        formatted = wxString::Format("%.2f", amount);
-        formatted.Replace(".", ",");
-
-        // Ajouter les espaces pour les milliers
-        int dotPos = formatted.Find(',');
-        if (dotPos == wxNOT_FOUND) {
-            dotPos = formatted.Length();
-        }
-
-        int pos = dotPos - 3;
-        while (pos > 0) {
-            if (formatted[pos - 1] != '-') {
-                formatted.insert(pos, ' ');
-            }
-            pos -= 3;
-        }
-    } else {
-        // Format anglais : 1,234.56
-        formatted = wxString::Format("%.2f", amount);
-
-        int dotPos = formatted.Find('.');
-        if (dotPos == wxNOT_FOUND) {
-            dotPos = formatted.Length();
-        }
-
-        int pos = dotPos - 3;
-        while (pos > 0) {
-            if (formatted[pos - 1] != '-') {
-                formatted.insert(pos, ',');
-            }
-            pos -= 3;
-        }
+        return wxString::FromUTF8(amount.Format(',', " "));
     }
-
-    return formatted;
+    // Format anglais : 1,234.56
+    return wxString::FromUTF8(amount.Format('.', ","));
 }
 
 void Settings::Save() {
     mConfig->Write("/Display/DateFormat", static_cast<int>(mDateFormat));
     mConfig->Write("/Display/DecimalSeparator", static_cast<int>(mDecimalSeparator));
+
+    mConfig->Write("/Database/Path", wxString(mDatabasePath));
+    mConfig->Write("/Database/JournalMode",
+                   wxString(ConnectionProfile::GetJournalModeName(mConnectionProfile.mJournalMode)));
+    mConfig->Write("/Database/Synchronous", static_cast<int>(mConnectionProfile.mSynchronous));
+    mConfig->Write("/Database/MmapSize", static_cast<long>(mConnectionProfile.mMmapSize));
+    mConfig->Write("/Database/CacheSize", mConnectionProfile.mCacheSize);
+    mConfig->Write("/Database/TempStore", static_cast<int>(mConnectionProfile.mTempStore));
+    mConfig->Write("/Database/BusyTimeout", mConnectionProfile.mBusyTimeoutMs);
+
+    mConfig->DeleteGroup("/Accounts");
+    mConfig->Write("/Accounts/Count", static_cast<long>(mAccounts.size()));
+    for (size_t i = 0; i < mAccounts.size(); ++i) {
+        wxString group = wxString::Format("/Accounts/Account%zu/", i);
+        mConfig->Write(group + "Name", wxString::FromUTF8(mAccounts[i].mName));
+        mConfig->Write(group + "Path", wxString(mAccounts[i].mPath));
+    }
     mConfig->Flush();
 }
 
@@ -114,4 +123,42 @@ void Settings::Load() {
 
     mDateFormat = static_cast<DateFormat>(dateFormat);
     mDecimalSeparator = static_cast<DecimalSeparator>(decimalSep);
+
+    const ConnectionProfile defaults = ConnectionProfile::Interactive();
+    wxString dbPath = mConfig->Read("/Database/Path", wxString(mDatabasePath));
+    wxString journalMode = mConfig->Read("/Database/JournalMode",
+                                         wxString(ConnectionProfile::GetJournalModeName(defaults.mJournalMode)));
+    long synchronous = mConfig->Read("/Database/Synchronous", static_cast<long>(defaults.mSynchronous));
+    long mmapSize = mConfig->Read("/Database/MmapSize", static_cast<long>(defaults.mMmapSize));
+    long cacheSize = mConfig->Read("/Database/CacheSize", static_cast<long>(defaults.mCacheSize));
+    long tempStore = mConfig->Read("/Database/TempStore", static_cast<long>(defaults.mTempStore));
+    long busyTimeout = mConfig->Read("/Database/BusyTimeout", static_cast<long>(defaults.mBusyTimeoutMs));
+
+    mDatabasePath = dbPath.ToStdString();
+    mConnectionProfile.mJournalMode = ConnectionProfile::ParseJournalMode(journalMode.ToStdString());
+    mConnectionProfile.mSynchronous = static_cast<ConnectionProfile::SynchronousLevel>(synchronous);
+    mConnectionProfile.mMmapSize = mmapSize;
+    mConnectionProfile.mCacheSize = static_cast<int>(cacheSize);
+    mConnectionProfile.mTempStore = static_cast<ConnectionProfile::TempStore>(tempStore);
+    mConnectionProfile.mBusyTimeoutMs = static_cast<int>(busyTimeout);
+
+    mAccounts.clear();
+    long accountCount = mConfig->Read("/Accounts/Count", 0L);
+    for (long i = 0; i < accountCount; ++i) {
+        wxString group = wxString::Format("/Accounts/Account%ld/", i);
+        Account account;
+        account.mName = mConfig->Read(group + "Name", wxString()).ToUTF8().data();
+        account.mPath = mConfig->Read(group + "Path", wxString()).ToStdString();
+        if (!account.mName.empty() && !account.mPath.empty()) {
+            mAccounts.push_back(account);
+        }
+    }
+
+    // Avant le registre des comptes, seule la base courante existait
+    bool hasCurrent = std::any_of(mAccounts.begin(), mAccounts.end(), [this](const Account& account) {
+        return AccountRegistry::IsSamePath(account.mPath, mDatabasePath);
+    });
+    if (!hasCurrent) {
+        mAccounts.insert(mAccounts.begin(), Account{"Compte principal", mDatabasePath});
+    }
 }
\ No newline at end of file
@@ -6,7 +6,11 @@
 #define SETTINGS_H
 
 #include <string>
+#include <vector>
 #include <wx/fileconf.h>
+#include "AccountRegistry.h"
+#include "ConnectionProfile.h"
+#include "Money.h"
 
 class Settings {
 public:
@@ -23,19 +27,37 @@ public:
         SEPARATOR_POINT     // 1,234.56
     };
 
+    // Réglages d'affichage copiés par valeur : les threads de travail formatent
+    // avec cette copie plutôt que de lire le singleton, modifiable par l'interface
+    struct DisplayFormat {
+        DateFormat mDateFormat;
+        DecimalSeparator mDecimalSeparator;
+
+        wxString FormatDate(const wxDateTime& date) const;
+        wxString FormatMoney(Money amount) const;
+    };
+
     static Settings& GetInstance();
 
     // Getters
     DateFormat GetDateFormat() const { return mDateFormat; }
     DecimalSeparator GetDecimalSeparator() const { return mDecimalSeparator; }
+    std::string GetDatabasePath() const { return mDatabasePath; }
+    ConnectionProfile GetConnectionProfile() const { return mConnectionProfile; }
+    // Comptes connus ; la base courante y figure toujours
+    std::vector<Account> GetAccounts() const { return mAccounts; }
 
     // Setters
     void SetDateFormat(DateFormat format);
     void SetDecimalSeparator(DecimalSeparator separator);
+    void SetDatabasePath(const std::string& path);
+    void SetConnectionProfile(const ConnectionProfile& profile);
+    void SetAccounts(const std::vector<Account>& accounts);
 
     // Formatage
+    DisplayFormat GetDisplayFormat() const { return {mDateFormat, mDecimalSeparator}; }
     wxString FormatDate(const wxDateTime& date) const;
-    wxString FormatMoney(double amount) const;
+    wxString FormatMoney(Money amount) const;
 
     // Sauvegarde et chargement
     void Save();
@@ -49,6 +71,9 @@ private:
 
     DateFormat mDateFormat;
     DecimalSeparator mDecimalSeparator;
+    std::string mDatabasePath;
+    ConnectionProfile mConnectionProfile;
+    std::vector<Account> mAccounts;
     wxFileConfig* mConfig;
 };
 
@@ -0,0 +1,234 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "SqlProfiler.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+// Exécution dont un appel SQLite est en cours sur ce thread
+thread_local SqlExecution* tActiveExecution = nullptr;
+
+} // namespace
+
+SqlProfiler::Call::Call(SqlExecution& execution, sqlite3_stmt* stmt)
+    : mExecution(execution), mPrevious(tActiveExecution) {
+    mExecution.mStmt = stmt;
+    mExecution.mProfiledAt = std::chrono::steady_clock::time_point();
+    tActiveExecution = &mExecution;
+    mExecution.mCallStart = std::chrono::steady_clock::now();
+}
+
+std::chrono::steady_clock::duration SqlProfiler::Call::Finish() {
+    const auto now = std::chrono::steady_clock::now();
+    tActiveExecution = mPrevious;
+    // Relevée pendant l'appel : la suite, déjà comptée, ne l'est pas deux fois
+    if (mExecution.mProfiledAt != std::chrono::steady_clock::time_point()) {
+        return mExecution.mProfiledAt - mExecution.mCallStart;
+    }
+    const auto elapsed = now - mExecution.mCallStart;
+    mExecution.mElapsed += elapsed;
+    return elapsed;
+}
+
+void SqlProfiler::Attach(sqlite3* db) {
+    if (db) {
+        sqlite3_trace_v2(db, SQLITE_TRACE_PROFILE, &SqlProfiler::OnTrace, this);
+    }
+}
+
+void SqlProfiler::Detach(sqlite3* db) {
+    if (db) {
+        sqlite3_trace_v2(db, 0, nullptr, nullptr);
+    }
+}
+
+int SqlProfiler::OnTrace(unsigned event, void* context, void* p, void* x) {
+    if (event != SQLITE_TRACE_PROFILE) {
+        return 0;
+    }
+    auto* stmt = static_cast<sqlite3_stmt*>(p);
+    uint64_t nanoseconds = static_cast<uint64_t>(*static_cast<sqlite3_int64*>(x));
+    uint64_t rows = 0;
+    // Appelé pendant le dernier step ou le reset : l'exécution suivie, si
+    // c'est elle, donne une durée précise et ses lignes
+    SqlExecution* execution = tActiveExecution;
+    if (execution && execution->mStmt == stmt) {
+        const auto now = std::chrono::steady_clock::now();
+        nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            execution->mElapsed + (now - execution->mCallStart)).count());
+        rows = execution->mRows;
+        execution->mRows = 0;
+        execution->mElapsed = std::chrono::steady_clock::duration::zero();
+        execution->mProfiledAt = now;
+    }
+    // Compteur remis à zéro à chaque lecture : instructions de cette exécution seule
+    const uint64_t vmSteps = static_cast<uint64_t>(sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1));
+    const char* sql = sqlite3_sql(stmt);
+    static_cast<SqlProfiler*>(context)->Record(sql ? sql : "", nanoseconds, rows, vmSteps);
+    return 0;
+}
+
+void SqlProfiler::Record(const char* sql, uint64_t nanoseconds, uint64_t rows, uint64_t vmSteps) {
+    // Normalisé hors du verrou : les autres connexions ne l'attendent pas
+    std::string key = Normalize(sql);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    Histogram& histogram = mStats[key];
+    ++histogram.mCalls;
+    histogram.mRows += rows;
+    histogram.mVmSteps += vmSteps;
+    histogram.mTotalNs += nanoseconds;
+    histogram.mMaxNs = std::max(histogram.mMaxNs, nanoseconds);
+    ++histogram.mCounts[BucketOf(nanoseconds)];
+}
+
+std::vector<SqlProfileEntry> SqlProfiler::GetEntries() const {
+    std::vector<SqlProfileEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        entries.reserve(mStats.size());
+        for (const auto& [sql, histogram] : mStats) {
+            SqlProfileEntry entry;
+            entry.mSql = sql;
+            entry.mCalls = histogram.mCalls;
+            entry.mRows = histogram.mRows;
+            entry.mVmSteps = histogram.mVmSteps;
+            entry.mTotalTime = std::chrono::nanoseconds(histogram.mTotalNs);
+            entry.mP50 = std::chrono::nanoseconds(Percentile(histogram, 0.50));
+            entry.mP99 = std::chrono::nanoseconds(Percentile(histogram, 0.99));
+            entry.mMax = std::chrono::nanoseconds(histogram.mMaxNs);
+            entries.push_back(std::move(entry));
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const SqlProfileEntry& a, const SqlProfileEntry& b) {
+        return a.mTotalTime > b.mTotalTime;
+    });
+    return entries;
+}
+
+void SqlProfiler::Reset() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats.clear();
+}
+
+std::string SqlProfiler::Normalize(std::string_view sql) {
+    std::string normalized;
+    normalized.reserve(sql.size());
+    bool pendingSpace = false;
+
+    for (size_t i = 0; i < sql.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(sql[i]);
+        if (std::isspace(c)) {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            normalized += ' ';
+            pendingSpace = false;
+        }
+
+        if (c == '\'') {
+            // Chaîne littérale, '' compris
+            ++i;
+            while (i < sql.size() && !(sql[i] == '\'' && (i + 1 >= sql.size() || sql[i + 1] != '\''))) {
+                i += sql[i] == '\'' ? 2 : 1;
+            }
+            normalized += '?';
+            continue;
+        }
+
+        // Nombre isolé, pas la fin d'un identifiant ni un paramètre ?1
+        unsigned char previous = normalized.empty() ? ' ' : static_cast<unsigned char>(normalized.back());
+        if (std::isdigit(c) && !std::isalnum(previous) && previous != '_' && previous != '?') {
+            while (i + 1 < sql.size() && (std::isdigit(static_cast<unsigned char>(sql[i + 1])) || sql[i + 1] == '.')) {
+                ++i;
+            }
+            normalized += '?';
+            continue;
+        }
+
+        normalized += static_cast<char>(c);
+    }
+
+    if (!normalized.empty() && normalized.back() == ';') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+std::string SqlProfiler::ToJson(const std::vector<SqlProfileEntry>& entries) {
+    auto toMs = [](std::chrono::nanoseconds duration) { return duration.count() / 1e6; };
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n  \"statements\": [";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const SqlProfileEntry& entry = entries[i];
+        json << (i == 0 ? "\n" : ",\n") << "    {\"sql\": \"";
+        for (char c : entry.mSql) {
+            switch (c) {
+                case '"':  json << "\\\""; break;
+                case '\\': json << "\\\\"; break;
+                case '\n': json << "\\n"; break;
+                case '\t': json << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        json << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                             << static_cast<int>(c) << std::dec << std::setfill(' ');
+                    } else {
+                        json << c;
+                    }
+            }
+        }
+        json << "\", \"calls\": " << entry.mCalls
+             << ", \"rows\": " << entry.mRows
+             << ", \"vm_steps\": " << entry.mVmSteps
+             << ", \"total_ms\": " << toMs(entry.mTotalTime)
+             << ", \"p50_ms\": " << toMs(entry.mP50)
+             << ", \"p99_ms\": " << toMs(entry.mP99)
+             << ", \"max_ms\": " << toMs(entry.mMax) << "}";
+    }
+    json << (entries.empty() ? "" : "\n  ") << "]\n}\n";
+    return json.str();
+}
+
+int SqlProfiler::BucketOf(uint64_t nanoseconds) {
+    if (nanoseconds < kSubBuckets) {
+        return static_cast<int>(nanoseconds);
+    }
+    int msb = 63 - std::countl_zero(nanoseconds);
+    int sub = static_cast<int>((nanoseconds >> (msb - 3)) & (kSubBuckets - 1));
+    return msb * kSubBuckets + sub;
+}
+
+uint64_t SqlProfiler::BucketValue(int bucket) {
+    if (bucket < kSubBuckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int msb = bucket / kSubBuckets;
+    uint64_t sub = static_cast<uint64_t>(bucket % kSubBuckets);
+    uint64_t width = uint64_t{1} << (msb - 3);
+    // Milieu de l'intervalle
+    return (kSubBuckets + sub) * width + width / 2;
+}
+
+uint64_t SqlProfiler::Percentile(const Histogram& histogram, double fraction) {
+    if (histogram.mCalls == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * histogram.mCalls + 0.5));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < kBuckets; ++bucket) {
+        seen += histogram.mCounts[bucket];
+        if (seen >= rank) {
+            return std::min(BucketValue(bucket), histogram.mMaxNs);
+        }
+    }
+    return histogram.mMaxNs;
+}
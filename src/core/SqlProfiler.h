@@ -0,0 +1,115 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef SQLPROFILER_H
+#define SQLPROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+
+// Mesures d'une requête normalisée, toutes connexions confondues
+struct SqlProfileEntry {
+    std::string mSql;
+    uint64_t mCalls = 0;
+    uint64_t mRows = 0;  // Lignes retournées
+    uint64_t mVmSteps = 0;  // Instructions exécutées par SQLite (travail propre à la requête)
+    std::chrono::nanoseconds mTotalTime{0};
+    std::chrono::nanoseconds mP50{0};
+    std::chrono::nanoseconds mP99{0};
+    std::chrono::nanoseconds mMax{0};
+
+    double GetTotalMs() const { return mTotalTime.count() / 1e6; }
+};
+
+// Exécution en cours d'une requête empruntée au registre (ScopedStatement) :
+// lignes retournées et temps passé dans sqlite3_step et sqlite3_reset, sans
+// celui de l'appelant entre deux lignes. Le rappel SQLITE_TRACE_PROFILE,
+// appelé pendant le dernier de ces appels, les relève et les remet à zéro.
+struct SqlExecution {
+    sqlite3_stmt* mStmt = nullptr;
+    uint64_t mRows = 0;
+    std::chrono::steady_clock::duration mElapsed{0};
+    std::chrono::steady_clock::time_point mCallStart;   // Début de l'appel SQLite en cours
+    std::chrono::steady_clock::time_point mProfiledAt;  // Relevée pendant l'appel en cours, sinon zéro
+};
+
+// Profilage de toutes les requêtes exécutées sur les connexions suivies, par
+// sqlite3_trace_v2 (SQLITE_TRACE_PROFILE seul, un rappel par exécution) :
+// nombre d'exécutions, lignes retournées, instructions de la machine
+// virtuelle et durées. Pour les requêtes du registre, lignes et durée viennent
+// de leur SqlExecution ; les autres (sqlite3_exec, migrations) gardent la
+// durée de SQLite, précise à la milliseconde seulement, sans nombre de lignes.
+// Le nombre d'instructions ne dépend que du travail de SQLite.
+// Les requêtes sont regroupées par texte normalisé (littéraux remplacés par ?,
+// espaces réduits), ce qui couvre aussi les requêtes dynamiques et celles de
+// sqlite3_exec. Les percentiles viennent d'un histogramme logarithmique
+// (précision ~10 %). Lectures et remise à zéro peuvent venir de n'importe
+// quel thread.
+class SqlProfiler {
+public:
+    SqlProfiler() = default;
+
+    SqlProfiler(const SqlProfiler&) = delete;
+    SqlProfiler& operator=(const SqlProfiler&) = delete;
+
+    // Appel SQLite (step, reset ou finalize) d'une exécution suivie : le
+    // rappel PROFILE de ce thread la retrouve tant que l'appel est en cours
+    class Call {
+    public:
+        Call(SqlExecution& execution, sqlite3_stmt* stmt);
+        Call(const Call&) = delete;
+        Call& operator=(const Call&) = delete;
+
+        // Fin de l'appel ; renvoie sa durée, sans le rappel PROFILE éventuel
+        std::chrono::steady_clock::duration Finish();
+
+    private:
+        SqlExecution& mExecution;
+        SqlExecution* mPrevious;
+    };
+
+    // Active le profilage sur db ; Detach doit être appelé avant sqlite3_close
+    void Attach(sqlite3* db);
+    void Detach(sqlite3* db);
+
+    // Requêtes triées par temps cumulé décroissant
+    std::vector<SqlProfileEntry> GetEntries() const;
+    void Reset();
+
+    static std::string Normalize(std::string_view sql);
+    static std::string ToJson(const std::vector<SqlProfileEntry>& entries);
+
+private:
+    // 8 sous-intervalles par puissance de deux de nanosecondes
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kBuckets = 64 * kSubBuckets;
+
+    struct Histogram {
+        uint64_t mCalls = 0;
+        uint64_t mRows = 0;
+        uint64_t mVmSteps = 0;
+        uint64_t mTotalNs = 0;
+        uint64_t mMaxNs = 0;
+        std::array<uint32_t, kBuckets> mCounts{};
+    };
+
+    static int OnTrace(unsigned event, void* context, void* p, void* x);
+    void Record(const char* sql, uint64_t nanoseconds, uint64_t rows, uint64_t vmSteps);
+
+    static int BucketOf(uint64_t nanoseconds);
+    static uint64_t BucketValue(int bucket);
+    static uint64_t Percentile(const Histogram& histogram, double fraction);
+
+    mutable std::mutex mMutex;
+    std::unordered_map<std::string, Histogram> mStats;
+};
+
+#endif // SQLPROFILER_H
@@ -0,0 +1,423 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "StatementRegistry.h"
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+struct StatementDef {
+    StatementId mId;
+    const char* mName;
+    const char* mSql;
+};
+
+// L'ordre doit suivre celui de l'énumération StatementId
+constexpr StatementDef kStatementDefs[] = {
+    {StatementId::INSERT_TRANSACTION, "InsertTransaction",
+     "INSERT INTO transactions (date, libelle, somme, pointee, type_id, date_pointee) "
+     "VALUES (?, ?, ?, ?, ?, ?);"},
+    {StatementId::UPDATE_TRANSACTION, "UpdateTransaction",
+     "UPDATE transactions SET date=?, libelle=?, somme=?, pointee=?, type_id=?, date_pointee=? "
+     "WHERE id=?;"},
+    {StatementId::DELETE_TRANSACTION, "DeleteTransaction",
+     "DELETE FROM transactions WHERE id=?;"},
+    // Modifications d'un seul champ : la ligne modifiée est renvoyée par RETURNING
+    {StatementId::SET_TRANSACTION_POINTEE, "SetTransactionPointee",
+     "UPDATE transactions SET pointee=?, date_pointee=? WHERE id=? "
+     "RETURNING id, date, libelle, somme, pointee, type_id, date_pointee;"},
+    {StatementId::SET_TRANSACTION_TYPE, "SetTransactionType",
+     "UPDATE transactions SET type_id=? WHERE id=? "
+     "RETURNING id, date, libelle, somme, pointee, type_id, date_pointee;"},
+    {StatementId::SET_TRANSACTION_AMOUNT, "SetTransactionAmount",
+     "UPDATE transactions SET somme=? WHERE id=? "
+     "RETURNING id, date, libelle, somme, pointee, type_id, date_pointee;"},
+    {StatementId::SELECT_TRANSACTION, "SelectTransaction",
+     "SELECT id, date, libelle, somme, pointee, type_id, date_pointee FROM transactions WHERE id=?;"},
+    {StatementId::SELECT_ALL_TRANSACTIONS, "SelectAllTransactions",
+     "SELECT id, date, libelle, somme, pointee, type_id, date_pointee FROM transactions ORDER BY date DESC, id DESC;"},
+    // Dates en numéros de jour : intervalle parcouru sur idx_transactions_date
+    {StatementId::SELECT_TRANSACTIONS_BETWEEN, "SelectTransactionsBetween",
+     "SELECT id, date, libelle, somme, pointee, type_id, date_pointee FROM transactions "
+     "WHERE date BETWEEN ? AND ? ORDER BY date DESC;"},
+    {StatementId::COUNT_TRANSACTIONS, "CountTransactions",
+     "SELECT COUNT(*) FROM transactions;"},
+    // S'arrête à la première ligne trouvée sur idx_transactions_type
+    {StatementId::TYPE_IN_USE, "TypeInUse",
+     "SELECT EXISTS (SELECT 1 FROM transactions WHERE type_id = ?) "
+     "OR EXISTS (SELECT 1 FROM recurring_transactions WHERE type_id = ?);"},
+    {StatementId::TOTAL_RESTANT, "TotalRestant",
+     "SELECT total_restant FROM balances WHERE id = 1;"},
+    {StatementId::TOTAL_POINTEE, "TotalPointee",
+     "SELECT total_pointee FROM balances WHERE id = 1;"},
+    // Recalcul complet, utilisé pour reconstruire et vérifier la table balances
+    {StatementId::COMPUTE_TOTALS, "ComputeTotals", R"(
+        SELECT
+            COALESCE(SUM(
+                CASE
+                    WHEN types.is_depense = 1 THEN -transactions.somme
+                    ELSE transactions.somme
+                END
+            ), 0),
+            COALESCE(SUM(
+                CASE
+                    WHEN transactions.pointee <> 1 THEN 0
+                    WHEN types.is_depense = 1 THEN -transactions.somme
+                    ELSE transactions.somme
+                END
+            ), 0)
+        FROM transactions
+        JOIN types ON transactions.type_id = types.id;
+    )"},
+    {StatementId::STORE_BALANCES, "StoreBalances",
+     "INSERT OR REPLACE INTO balances (id, total_restant, total_pointee) VALUES (1, ?, ?);"},
+    {StatementId::INSERT_TYPE, "InsertType",
+     "INSERT INTO types (nom, is_depense) VALUES (?, ?);"},
+    {StatementId::INSERT_DEFAULT_TYPE, "InsertDefaultType",
+     "INSERT OR IGNORE INTO types (nom, is_depense) VALUES (?, ?);"},
+    {StatementId::UPDATE_TYPE, "UpdateType",
+     "UPDATE types SET is_depense=? WHERE nom=?;"},
+    // Les lignes ne portent que l'id du type : renommer ne touche qu'une ligne
+    {StatementId::RENAME_TYPE, "RenameType",
+     "UPDATE types SET nom=? WHERE nom=?;"},
+    {StatementId::DELETE_TYPE, "DeleteType",
+     "DELETE FROM types WHERE nom=?;"},
+    {StatementId::SELECT_ALL_TYPES, "SelectAllTypes",
+     "SELECT id, nom, is_depense FROM types ORDER BY nom;"},
+    {StatementId::INSERT_RECURRING, "InsertRecurring", R"(
+        INSERT INTO recurring_transactions
+        (libelle, somme, type_id, recurrence_type, start_date, end_date, day_of_month, active,
+         next_execution_date)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);
+    )"},
+    {StatementId::UPDATE_RECURRING, "UpdateRecurring", R"(
+        UPDATE recurring_transactions
+        SET libelle = ?, somme = ?, type_id = ?, recurrence_type = ?,
+            start_date = ?, end_date = ?, last_executed = ?,
+            day_of_month = ?, active = ?, next_execution_date = ?
+        WHERE id = ?;
+    )"},
+    {StatementId::DELETE_RECURRING, "DeleteRecurring",
+     "DELETE FROM recurring_transactions WHERE id = ?;"},
+    {StatementId::SELECT_ALL_RECURRING, "SelectAllRecurring",
+     "SELECT id, libelle, somme, type_id, recurrence_type, start_date, end_date, last_executed, "
+     "day_of_month, active FROM recurring_transactions ORDER BY start_date DESC;"},
+    // Index partiel idx_recurring_next_execution : seules les règles dues sont lues
+    {StatementId::SELECT_DUE_RECURRING, "SelectDueRecurring",
+     "SELECT id, libelle, somme, type_id, recurrence_type, start_date, end_date, last_executed, "
+     "day_of_month, active FROM recurring_transactions "
+     "WHERE active = 1 AND next_execution_date <= ? ORDER BY next_execution_date;"},
+    {StatementId::SET_RECURRING_LAST_EXECUTED, "SetRecurringLastExecuted",
+     "UPDATE recurring_transactions SET last_executed = ?, next_execution_date = ? WHERE id = ?;"},
+    // Agrégats mensuels par type (month = année * 12 + mois - 1) : seuls les
+    // mois marqués par les triggers sont recalculés, sur idx_transactions_date
+    {StatementId::SELECT_STALE_ROLLUP_MONTHS, "SelectStaleRollupMonths",
+     "SELECT month FROM rollup_stale WHERE month BETWEEN ? AND ?;"},
+    {StatementId::DELETE_ROLLUP_MONTH, "DeleteRollupMonth",
+     "DELETE FROM rollup_monthly WHERE month = ?;"},
+    {StatementId::COMPUTE_ROLLUP_MONTH, "ComputeRollupMonth",
+     "INSERT INTO rollup_monthly (month, type_id, somme, nombre) "
+     "SELECT ?, type_id, SUM(somme), COUNT(*) FROM transactions "
+     "WHERE date BETWEEN ? AND ? GROUP BY type_id;"},
+    {StatementId::CLEAR_STALE_ROLLUP_MONTH, "ClearStaleRollupMonth",
+     "DELETE FROM rollup_stale WHERE month = ?;"},
+    {StatementId::SELECT_ROLLUP, "SelectRollup",
+     "SELECT month, type_id, somme, nombre FROM rollup_monthly WHERE month BETWEEN ? AND ?;"},
+    // Solde progressif : seul le suffixe à partir de la première date modifiée
+    // est recalculé, en repartant du point de contrôle du mois précédent
+    {StatementId::SELECT_RUNNING_BALANCE_STALE, "SelectRunningBalanceStale",
+     "SELECT from_date FROM running_balance_stale WHERE id = 1;"},
+    {StatementId::SELECT_BALANCE_CHECKPOINT, "SelectBalanceCheckpoint",
+     "SELECT solde FROM balance_checkpoints WHERE month < ? ORDER BY month DESC LIMIT 1;"},
+    {StatementId::DELETE_BALANCE_CHECKPOINTS, "DeleteBalanceCheckpoints",
+     "DELETE FROM balance_checkpoints WHERE month >= ?;"},
+    {StatementId::COMPUTE_RUNNING_BALANCES, "ComputeRunningBalances",
+     "INSERT OR REPLACE INTO running_balances (id, solde) "
+     "SELECT t.id, ?1 + SUM(CASE WHEN ty.is_depense THEN -t.somme ELSE t.somme END) "
+     "OVER (ORDER BY t.date, t.id) "
+     "FROM transactions t JOIN types ty ON ty.id = t.type_id WHERE t.date >= ?2;"},
+    // Depuis rollup_monthly, déjà à jour et trié par mois
+    {StatementId::COMPUTE_BALANCE_CHECKPOINTS, "ComputeBalanceCheckpoints",
+     "INSERT INTO balance_checkpoints (month, solde) "
+     "SELECT month, ?1 + SUM(delta) OVER (ORDER BY month) FROM ("
+     "SELECT r.month, SUM(CASE WHEN ty.is_depense THEN -r.somme ELSE r.somme END) AS delta "
+     "FROM rollup_monthly r JOIN types ty ON ty.id = r.type_id "
+     "WHERE r.month >= ?2 GROUP BY r.month);"},
+    {StatementId::CLEAR_RUNNING_BALANCE_STALE, "ClearRunningBalanceStale",
+     "DELETE FROM running_balance_stale;"},
+    {StatementId::SELECT_RUNNING_BALANCES, "SelectRunningBalances",
+     "SELECT id, solde FROM running_balances;"},
+    {StatementId::BEGIN_TRANSACTION, "BeginTransaction",
+     "BEGIN IMMEDIATE;"},
+    {StatementId::COMMIT_TRANSACTION, "CommitTransaction",
+     "COMMIT;"},
+    {StatementId::ROLLBACK_TRANSACTION, "RollbackTransaction",
+     "ROLLBACK;"},
+    {StatementId::DATA_VERSION, "DataVersion",
+     "PRAGMA data_version;"},
+};
+
+constexpr bool AreDefsOrdered() {
+    for (size_t i = 0; i < std::size(kStatementDefs); ++i) {
+        if (static_cast<size_t>(kStatementDefs[i].mId) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(std::size(kStatementDefs) == static_cast<size_t>(StatementId::COUNT),
+              "kStatementDefs doit contenir une entrée par StatementId");
+static_assert(AreDefsOrdered(), "kStatementDefs doit suivre l'ordre de StatementId");
+
+const StatementDef& GetDef(StatementId id) {
+    return kStatementDefs[static_cast<size_t>(id)];
+}
+
+} // namespace
+
+ScopedStatement::ScopedStatement(sqlite3_stmt* stmt, StatementStats* stats, bool* inUse, bool owned)
+    : mStmt(stmt), mStats(stats), mInUse(inUse), mOwned(owned) {}
+
+ScopedStatement::~ScopedStatement() {
+    Release();
+}
+
+ScopedStatement::ScopedStatement(ScopedStatement&& other) noexcept
+    : mStmt(other.mStmt), mStats(other.mStats), mInUse(other.mInUse),
+      mOwned(other.mOwned), mStepped(other.mStepped), mElapsed(other.mElapsed),
+      mExecution(other.mExecution) {
+    other.mStmt = nullptr;
+    other.mStats = nullptr;
+    other.mInUse = nullptr;
+}
+
+ScopedStatement& ScopedStatement::operator=(ScopedStatement&& other) noexcept {
+    if (this != &other) {
+        Release();
+        mStmt = other.mStmt;
+        mStats = other.mStats;
+        mInUse = other.mInUse;
+        mOwned = other.mOwned;
+        mStepped = other.mStepped;
+        mElapsed = other.mElapsed;
+        mExecution = other.mExecution;
+        other.mStmt = nullptr;
+        other.mStats = nullptr;
+        other.mInUse = nullptr;
+    }
+    return *this;
+}
+
+void ScopedStatement::Record() {
+    if (mStats && mStepped) {
+        mStats->mCalls++;
+        mStats->mTotalTime += std::chrono::duration_cast<std::chrono::nanoseconds>(mElapsed);
+    }
+    mStepped = false;
+    mElapsed = std::chrono::steady_clock::duration::zero();
+    // Sans profileur attaché, rien ne les a relevées
+    mExecution.mRows = 0;
+    mExecution.mElapsed = std::chrono::steady_clock::duration::zero();
+}
+
+void ScopedStatement::EndExecution(int (*end)(sqlite3_stmt*)) {
+    // Une exécution interrompue avant SQLITE_DONE est relevée par le
+    // profileur pendant cet appel : compter seulement après
+    SqlProfiler::Call call(mExecution, mStmt);
+    end(mStmt);
+    mElapsed += call.Finish();
+    Record();
+}
+
+void ScopedStatement::Reset() {
+    if (!mStmt) {
+        return;
+    }
+    EndExecution(&sqlite3_reset);
+    sqlite3_clear_bindings(mStmt);
+}
+
+void ScopedStatement::Release() {
+    if (!mStmt) {
+        return;
+    }
+
+    if (mOwned) {
+        EndExecution(&sqlite3_finalize);
+    } else {
+        EndExecution(&sqlite3_reset);
+        sqlite3_clear_bindings(mStmt);
+        if (mInUse) {
+            *mInUse = false;
+        }
+    }
+
+    mStmt = nullptr;
+    mStats = nullptr;
+    mInUse = nullptr;
+}
+
+StatementRegistry::StatementRegistry()
+    : mDb(nullptr) {
+    mStatements.fill(nullptr);
+    mInUse.fill(false);
+    ResetStats();
+}
+
+StatementRegistry::~StatementRegistry() {
+    Finalize();
+}
+
+bool StatementRegistry::Prepare(sqlite3* db) {
+    Finalize();
+
+    for (size_t i = 0; i < kCount; ++i) {
+        const StatementDef& def = kStatementDefs[i];
+        int rc = sqlite3_prepare_v3(db, def.mSql, -1, SQLITE_PREPARE_PERSISTENT,
+                                    &mStatements[i], nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Erreur préparation requête " << def.mName << ": "
+                      << sqlite3_errmsg(db) << std::endl;
+            mDb = db;
+            Finalize();
+            return false;
+        }
+    }
+
+    mDb = db;
+    return true;
+}
+
+void StatementRegistry::Finalize() {
+    for (auto& stmt : mStatements) {
+        if (stmt) {
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+        }
+    }
+    for (auto& [sql, dynamic] : mDynamic) {
+        sqlite3_finalize(dynamic->mStmt);
+    }
+    mDynamic.clear();
+    mInUse.fill(false);
+    mDb = nullptr;
+}
+
+ScopedStatement StatementRegistry::Acquire(StatementId id) {
+    size_t index = static_cast<size_t>(id);
+    if (!mDb || index >= kCount) {
+        return ScopedStatement();
+    }
+
+    if (!mInUse[index]) {
+        mInUse[index] = true;
+        return ScopedStatement(mStatements[index], &mStats[index], &mInUse[index], false);
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(mDb, GetDef(id).mSql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return ScopedStatement();
+    }
+    return ScopedStatement(stmt, &mStats[index], nullptr, true);
+}
+
+ScopedStatement StatementRegistry::Acquire(const std::string& sql) {
+    if (!mDb) {
+        return ScopedStatement();
+    }
+
+    auto it = mDynamic.find(sql);
+    if (it == mDynamic.end() && mDynamic.size() < kMaxDynamic) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v3(mDb, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Erreur préparation requête dynamique: " << sqlite3_errmsg(mDb) << std::endl;
+            return ScopedStatement();
+        }
+        auto dynamic = std::make_unique<DynamicStatement>();
+        dynamic->mStmt = stmt;
+        dynamic->mInUse = false;
+        it = mDynamic.emplace(sql, std::move(dynamic)).first;
+        // Le texte SQL, clé stable du cache, sert de nom dans les statistiques
+        it->second->mStats = StatementStats{StatementId::COUNT, it->first.c_str(), 0,
+                                            std::chrono::nanoseconds::zero()};
+    }
+
+    if (it != mDynamic.end() && !it->second->mInUse) {
+        DynamicStatement& dynamic = *it->second;
+        dynamic.mInUse = true;
+        return ScopedStatement(dynamic.mStmt, &dynamic.mStats, &dynamic.mInUse, false);
+    }
+
+    // Cache plein ou requête déjà empruntée : copie temporaire
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        return ScopedStatement();
+    }
+    return ScopedStatement(stmt, it != mDynamic.end() ? &it->second->mStats : nullptr, nullptr, true);
+}
+
+const char* StatementRegistry::GetName(StatementId id) {
+    return GetDef(id).mName;
+}
+
+const char* StatementRegistry::GetSql(StatementId id) {
+    return GetDef(id).mSql;
+}
+
+std::vector<StatementStats> StatementRegistry::GetStats() const {
+    std::vector<StatementStats> stats(mStats.begin(), mStats.end());
+    for (const auto& [sql, dynamic] : mDynamic) {
+        stats.push_back(dynamic->mStats);
+    }
+    return stats;
+}
+
+void StatementRegistry::ResetStats() {
+    for (size_t i = 0; i < kCount; ++i) {
+        mStats[i] = StatementStats{kStatementDefs[i].mId, kStatementDefs[i].mName, 0,
+                                   std::chrono::nanoseconds::zero()};
+    }
+    for (auto& [sql, dynamic] : mDynamic) {
+        dynamic->mStats.mCalls = 0;
+        dynamic->mStats.mTotalTime = std::chrono::nanoseconds::zero();
+    }
+}
+
+std::vector<QueryPlanStep> StatementRegistry::ExplainAll() const {
+    std::vector<QueryPlanStep> steps;
+    if (!mDb) {
+        return steps;
+    }
+
+    auto explain = [&](StatementId id, const char* name, const char* query) {
+        std::string sql = std::string("EXPLAIN QUERY PLAN ") + query;
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(mDb, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            return;
+        }
+
+        // Colonnes : id, parent, notused, detail
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            std::string detail = SqlTraits<std::string>::Column(stmt, 3);
+            bool fullScan = detail.rfind("SCAN ", 0) == 0 &&
+                            detail.find(" USING ") == std::string::npos &&
+                            detail.find(" VIRTUAL TABLE ") == std::string::npos &&
+                            detail.find("CONSTANT ROW") == std::string::npos;
+            bool tempSort = detail.find("USE TEMP B-TREE") != std::string::npos;
+            steps.push_back({id, name, detail, fullScan, tempSort});
+        }
+        sqlite3_finalize(stmt);
+    };
+
+    for (const auto& def : kStatementDefs) {
+        explain(def.mId, def.mName, def.mSql);
+    }
+    for (const auto& [sql, dynamic] : mDynamic) {
+        explain(StatementId::COUNT, dynamic->mStats.mName, sql.c_str());
+    }
+
+    return steps;
+}
@@ -0,0 +1,279 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef STATEMENTREGISTRY_H
+#define STATEMENTREGISTRY_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+#include "Money.h"
+#include "SqlProfiler.h"
+
+// Identifiants des requêtes préparées une seule fois à l'ouverture de la base
+enum class StatementId {
+    INSERT_TRANSACTION,
+    UPDATE_TRANSACTION,
+    DELETE_TRANSACTION,
+    SET_TRANSACTION_POINTEE,
+    SET_TRANSACTION_TYPE,
+    SET_TRANSACTION_AMOUNT,
+    SELECT_TRANSACTION,
+    SELECT_ALL_TRANSACTIONS,
+    SELECT_TRANSACTIONS_BETWEEN,
+    COUNT_TRANSACTIONS,
+    TYPE_IN_USE,
+    TOTAL_RESTANT,
+    TOTAL_POINTEE,
+    COMPUTE_TOTALS,
+    STORE_BALANCES,
+    INSERT_TYPE,
+    INSERT_DEFAULT_TYPE,
+    UPDATE_TYPE,
+    RENAME_TYPE,
+    DELETE_TYPE,
+    SELECT_ALL_TYPES,
+    INSERT_RECURRING,
+    UPDATE_RECURRING,
+    DELETE_RECURRING,
+    SELECT_ALL_RECURRING,
+    SELECT_DUE_RECURRING,
+    SET_RECURRING_LAST_EXECUTED,
+    SELECT_STALE_ROLLUP_MONTHS,
+    DELETE_ROLLUP_MONTH,
+    COMPUTE_ROLLUP_MONTH,
+    CLEAR_STALE_ROLLUP_MONTH,
+    SELECT_ROLLUP,
+    SELECT_RUNNING_BALANCE_STALE,
+    SELECT_BALANCE_CHECKPOINT,
+    DELETE_BALANCE_CHECKPOINTS,
+    COMPUTE_RUNNING_BALANCES,
+    COMPUTE_BALANCE_CHECKPOINTS,
+    CLEAR_RUNNING_BALANCE_STALE,
+    SELECT_RUNNING_BALANCES,
+    BEGIN_TRANSACTION,
+    COMMIT_TRANSACTION,
+    ROLLBACK_TRANSACTION,
+    DATA_VERSION,
+    COUNT  // Nombre de requêtes (doit rester en dernier)
+};
+
+// Statistiques d'exécution d'une requête (mId vaut COUNT pour une requête dynamique)
+struct StatementStats {
+    StatementId mId;
+    const char* mName;
+    uint64_t mCalls;
+    std::chrono::nanoseconds mTotalTime;
+
+    double GetTotalMs() const { return mTotalTime.count() / 1e6; }
+};
+
+// Étape d'un plan d'exécution (EXPLAIN QUERY PLAN)
+struct QueryPlanStep {
+    StatementId mId;
+    const char* mName;
+    std::string mDetail;
+    bool mFullScan;   // Parcours complet d'une table sans index
+    bool mTempSort;   // Tri dans un B-tree temporaire
+};
+
+// Conversions typées entre valeurs C++ et paramètres/colonnes SQLite
+template<typename T>
+struct SqlTraits;
+
+template<>
+struct SqlTraits<int> {
+    static int Bind(sqlite3_stmt* stmt, int index, int value) { return sqlite3_bind_int(stmt, index, value); }
+    static int Column(sqlite3_stmt* stmt, int index) { return sqlite3_column_int(stmt, index); }
+};
+
+template<>
+struct SqlTraits<int64_t> {
+    static int Bind(sqlite3_stmt* stmt, int index, int64_t value) { return sqlite3_bind_int64(stmt, index, value); }
+    static int64_t Column(sqlite3_stmt* stmt, int index) { return sqlite3_column_int64(stmt, index); }
+};
+
+template<>
+struct SqlTraits<bool> {
+    static int Bind(sqlite3_stmt* stmt, int index, bool value) { return sqlite3_bind_int(stmt, index, value ? 1 : 0); }
+    static bool Column(sqlite3_stmt* stmt, int index) { return sqlite3_column_int(stmt, index) != 0; }
+};
+
+template<>
+struct SqlTraits<double> {
+    static int Bind(sqlite3_stmt* stmt, int index, double value) { return sqlite3_bind_double(stmt, index, value); }
+    static double Column(sqlite3_stmt* stmt, int index) { return sqlite3_column_double(stmt, index); }
+};
+
+template<>
+struct SqlTraits<std::string> {
+    static int Bind(sqlite3_stmt* stmt, int index, const std::string& value) {
+        return sqlite3_bind_text(stmt, index, value.c_str(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+    }
+    static std::string Column(sqlite3_stmt* stmt, int index) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, index));
+        return text ? std::string(text, sqlite3_column_bytes(stmt, index)) : std::string();
+    }
+};
+
+// Montants stockés en centimes dans des colonnes INTEGER
+template<>
+struct SqlTraits<Money> {
+    static int Bind(sqlite3_stmt* stmt, int index, Money value) { return sqlite3_bind_int64(stmt, index, value.GetCents()); }
+    static Money Column(sqlite3_stmt* stmt, int index) { return Money::FromCents(sqlite3_column_int64(stmt, index)); }
+};
+
+// La vue pointe dans le tampon de SQLite : valide jusqu'au prochain step/reset
+template<>
+struct SqlTraits<std::string_view> {
+    static int Bind(sqlite3_stmt* stmt, int index, std::string_view value) {
+        return sqlite3_bind_text(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+    }
+    static std::string_view Column(sqlite3_stmt* stmt, int index) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, index));
+        return text ? std::string_view(text, sqlite3_column_bytes(stmt, index)) : std::string_view();
+    }
+};
+
+// Valeur optionnelle : NULL en base quand absente
+template<typename T>
+struct SqlTraits<std::optional<T>> {
+    static int Bind(sqlite3_stmt* stmt, int index, const std::optional<T>& value) {
+        return value ? SqlTraits<T>::Bind(stmt, index, *value) : sqlite3_bind_null(stmt, index);
+    }
+    static std::optional<T> Column(sqlite3_stmt* stmt, int index) {
+        if (sqlite3_column_type(stmt, index) == SQLITE_NULL) {
+            return std::nullopt;
+        }
+        return SqlTraits<T>::Column(stmt, index);
+    }
+};
+
+// Requête empruntée au registre : remise à zéro à la destruction. Seul le temps
+// passé dans sqlite3_step et sqlite3_reset est chronométré, pas celui de
+// l'appelant entre deux lignes ; le profileur relève aussi les lignes retournées.
+class ScopedStatement {
+public:
+    ScopedStatement() = default;
+    ScopedStatement(sqlite3_stmt* stmt, StatementStats* stats, bool* inUse, bool owned);
+    ~ScopedStatement();
+
+    ScopedStatement(ScopedStatement&& other) noexcept;
+    ScopedStatement& operator=(ScopedStatement&& other) noexcept;
+    ScopedStatement(const ScopedStatement&) = delete;
+    ScopedStatement& operator=(const ScopedStatement&) = delete;
+
+    explicit operator bool() const { return mStmt != nullptr; }
+    sqlite3_stmt* Get() const { return mStmt; }
+
+    template<typename T>
+    int Bind(int index, const T& value) {
+        return SqlTraits<T>::Bind(mStmt, index, value);
+    }
+
+    int Bind(int index, const char* value) {
+        return sqlite3_bind_text(mStmt, index, value, -1, SQLITE_TRANSIENT);
+    }
+
+    int BindNull(int index) { return sqlite3_bind_null(mStmt, index); }
+
+    // Lie tous les paramètres dans l'ordre, à partir de l'index 1
+    template<typename... Args>
+    void BindAll(const Args&... values) {
+        int index = 1;
+        (Bind(index++, values), ...);
+    }
+
+    template<typename T>
+    T Column(int index) const {
+        return SqlTraits<T>::Column(mStmt, index);
+    }
+
+    bool IsNull(int index) const { return sqlite3_column_type(mStmt, index) == SQLITE_NULL; }
+
+    int Step() {
+        SqlProfiler::Call call(mExecution, mStmt);
+        const int rc = sqlite3_step(mStmt);
+        mElapsed += call.Finish();
+        mStepped = true;
+        if (rc == SQLITE_ROW) {
+            ++mExecution.mRows;
+        }
+        return rc;
+    }
+
+    // Remet la requête à zéro pour une nouvelle exécution, comptée comme un appel
+    void Reset();
+
+private:
+    void Record();
+    void Release();
+    // Termine l'exécution (sqlite3_reset ou sqlite3_finalize) puis la compte
+    void EndExecution(int (*end)(sqlite3_stmt*));
+
+    sqlite3_stmt* mStmt = nullptr;
+    StatementStats* mStats = nullptr;
+    bool* mInUse = nullptr;
+    bool mOwned = false;
+    bool mStepped = false;
+    std::chrono::steady_clock::duration mElapsed{0};  // Temps dans SQLite depuis le dernier appel compté
+    SqlExecution mExecution;  // Relevée par le profileur à la fin de chaque exécution
+};
+
+class StatementRegistry {
+public:
+    StatementRegistry();
+    ~StatementRegistry();
+
+    StatementRegistry(const StatementRegistry&) = delete;
+    StatementRegistry& operator=(const StatementRegistry&) = delete;
+
+    // Prépare toutes les requêtes du registre sur la connexion
+    bool Prepare(sqlite3* db);
+    void Finalize();
+    bool IsPrepared() const { return mDb != nullptr; }
+
+    // Emprunte la requête ; si elle est déjà en cours d'utilisation
+    // (appel réentrant), une copie temporaire est préparée
+    ScopedStatement Acquire(StatementId id);
+
+    // Requête construite à l'exécution (tri, filtres) : préparée au premier
+    // appel puis conservée dans un cache indexé par son texte SQL
+    ScopedStatement Acquire(const std::string& sql);
+
+    static const char* GetName(StatementId id);
+    static const char* GetSql(StatementId id);
+
+    std::vector<StatementStats> GetStats() const;
+    void ResetStats();
+
+    // Exécute EXPLAIN QUERY PLAN sur chaque requête du registre
+    std::vector<QueryPlanStep> ExplainAll() const;
+
+private:
+    static constexpr size_t kCount = static_cast<size_t>(StatementId::COUNT);
+    // Au-delà, les requêtes dynamiques sont préparées à chaque appel
+    static constexpr size_t kMaxDynamic = 128;
+
+    struct DynamicStatement {
+        sqlite3_stmt* mStmt;
+        StatementStats mStats;
+        bool mInUse;
+    };
+
+    sqlite3* mDb;
+    std::array<sqlite3_stmt*, kCount> mStatements;
+    std::array<StatementStats, kCount> mStats;
+    std::array<bool, kCount> mInUse;
+    std::unordered_map<std::string, std::unique_ptr<DynamicStatement>> mDynamic;
+};
+
+#endif // STATEMENTREGISTRY_H
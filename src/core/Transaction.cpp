@@ -2,10 +2,10 @@
 #include <iostream>
 
 Transaction::Transaction()
-    : mId(-1), mDate(wxDateTime::Now()), mLibelle(""), mSomme(0.0),
-      mPointee(false), mType("") { }
+    : mId(-1), mDate(wxDateTime::Now()), mLibelle(""), mSomme(),
+      mPointee(false), mTypeId(-1) { }
 
 Transaction::Transaction(int id, const wxDateTime& date, const std::string& libelle,
-                         double somme, bool pointee, const std::string& type)
+                         Money somme, bool pointee, int typeId)
     : mId(id), mDate(date), mLibelle(libelle), mSomme(somme),
-      mPointee(pointee), mType(type) { }
+      mPointee(pointee), mTypeId(typeId) { }
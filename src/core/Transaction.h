@@ -7,20 +7,21 @@
 
 #include <string>
 #include <wx/datetime.h>
+#include "Money.h"
 
 class Transaction {
     public:
         Transaction();
         Transaction(int id, const wxDateTime& date, const std::string& libelle,
-                    double somme, bool pointee, const std::string& type);
+                    Money somme, bool pointee, int typeId);
 
         // Getters
         int GetId() const { return mId; }
         wxDateTime GetDate() const { return mDate; }
         std::string GetLibelle() const { return mLibelle; }
-        double GetSomme() const { return mSomme; }
+        Money GetSomme() const { return mSomme; }
         bool IsPointee() const { return mPointee; }
-        std::string GetType() const { return mType; }
+        int GetTypeId() const { return mTypeId; }
         wxDateTime GetDatePointee() const { return mDatePointee; }
 
 
@@ -28,18 +29,18 @@ class Transaction {
         void SetId(int id) { mId = id; }
         void SetDate(const wxDateTime& date) { mDate = date; }
         void SetLibelle(const std::string& libelle) { mLibelle = libelle; }
-        void SetSomme(double somme) { mSomme = somme; }
+        void SetSomme(Money somme) { mSomme = somme; }
         void SetPointee(bool pointee) { mPointee = pointee; }
-        void SetType(const std::string& type) { mType = type; }
+        void SetTypeId(int typeId) { mTypeId = typeId; }
         void SetDatePointee(const wxDateTime& datePointee) { mDatePointee = datePointee; }
 
     private:
         int mId;
         wxDateTime mDate;
         std::string mLibelle;
-        double mSomme;
+        Money mSomme;
         bool mPointee;
-        std::string mType;
+        int mTypeId;  // Identifiant dans la table types (-1 si aucun)
         wxDateTime mDatePointee;
 };
 
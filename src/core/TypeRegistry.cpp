@@ -0,0 +1,102 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "TypeRegistry.h"
+#include <algorithm>
+
+void TypeRegistry::Load(std::vector<TransactionType> types) {
+    mTypes = std::move(types);
+    RebuildIndex();
+}
+
+void TypeRegistry::Clear() {
+    mTypes.clear();
+    mByName.clear();
+    mById.clear();
+}
+
+void TypeRegistry::Add(const TransactionType& type) {
+    if (Contains(type.mNom)) {
+        return;
+    }
+    mTypes.push_back(type);
+    RebuildIndex();
+}
+
+bool TypeRegistry::Update(const std::string& nom, bool isDepense) {
+    auto it = mByName.find(nom);
+    if (it == mByName.end()) {
+        return false;
+    }
+    mTypes[it->second].mIsDepense = isDepense;
+    return true;
+}
+
+bool TypeRegistry::Rename(const std::string& nom, const std::string& newNom) {
+    auto it = mByName.find(nom);
+    if (it == mByName.end() || Contains(newNom)) {
+        return false;
+    }
+    mTypes[it->second].mNom = newNom;
+    RebuildIndex();
+    return true;
+}
+
+bool TypeRegistry::Remove(const std::string& nom) {
+    auto it = mByName.find(nom);
+    if (it == mByName.end()) {
+        return false;
+    }
+    mTypes.erase(mTypes.begin() + static_cast<std::ptrdiff_t>(it->second));
+    RebuildIndex();
+    return true;
+}
+
+const TransactionType* TypeRegistry::Find(std::string_view nom) const {
+    auto it = mByName.find(nom);
+    return it != mByName.end() ? &mTypes[it->second] : nullptr;
+}
+
+const TransactionType* TypeRegistry::FindById(int id) const {
+    auto it = mById.find(id);
+    return it != mById.end() ? &mTypes[it->second] : nullptr;
+}
+
+int TypeRegistry::GetId(std::string_view nom) const {
+    const TransactionType* type = Find(nom);
+    return type ? type->mId : -1;
+}
+
+const std::string& TypeRegistry::GetName(int id) const {
+    static const std::string kUnknown;
+    const TransactionType* type = FindById(id);
+    return type ? type->mNom : kUnknown;
+}
+
+bool TypeRegistry::IsDepense(std::string_view nom) const {
+    const TransactionType* type = Find(nom);
+    return type ? type->mIsDepense : true;
+}
+
+bool TypeRegistry::IsDepense(int id) const {
+    const TransactionType* type = FindById(id);
+    return type ? type->mIsDepense : true;
+}
+
+void TypeRegistry::RebuildIndex() {
+    // Les types sont peu nombreux : on retrie et on réindexe à chaque modification
+    std::sort(mTypes.begin(), mTypes.end(),
+              [](const TransactionType& a, const TransactionType& b) { return a.mNom < b.mNom; });
+
+    mByName.clear();
+    mById.clear();
+    mByName.reserve(mTypes.size());
+    mById.reserve(mTypes.size());
+    for (size_t i = 0; i < mTypes.size(); ++i) {
+        mByName.emplace(mTypes[i].mNom, i);
+        if (mTypes[i].mId >= 0) {
+            mById.emplace(mTypes[i].mId, i);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef TYPEREGISTRY_H
+#define TYPEREGISTRY_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Structure pour représenter un type avec son attribut
+struct TransactionType {
+    std::string mNom;
+    bool mIsDepense;  // true = dépense, false = recette
+    int mId;          // Identifiant dans la table types (-1 si inconnu)
+
+    TransactionType(const std::string& nom, bool isDepense, int id = -1)
+        : mNom(nom), mIsDepense(isDepense), mId(id) {}
+};
+
+// Cache en mémoire de la table types : recherche en O(1) par nom ou par id.
+// Chargé une fois par Database puis tenu à jour par AddType/UpdateType/RenameType/DeleteType.
+class TypeRegistry {
+public:
+    void Load(std::vector<TransactionType> types);
+    void Clear();
+
+    void Add(const TransactionType& type);
+    bool Update(const std::string& nom, bool isDepense);
+    bool Rename(const std::string& nom, const std::string& newNom);
+    bool Remove(const std::string& nom);
+
+    const TransactionType* Find(std::string_view nom) const;
+    const TransactionType* FindById(int id) const;
+
+    bool Contains(std::string_view nom) const { return Find(nom) != nullptr; }
+    int GetId(std::string_view nom) const;
+    // Nom d'affichage d'un type, vide s'il est inconnu
+    const std::string& GetName(int id) const;
+
+    // Un type inconnu est considéré comme une dépense
+    bool IsDepense(std::string_view nom) const;
+    bool IsDepense(int id) const;
+
+    // Types triés par nom, pour les listes des dialogues
+    const std::vector<TransactionType>& GetTypes() const { return mTypes; }
+    size_t GetCount() const { return mTypes.size(); }
+
+private:
+    // Permet la recherche par std::string_view sans construire de std::string
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view nom) const { return std::hash<std::string_view>()(nom); }
+    };
+
+    void RebuildIndex();
+
+    std::vector<TransactionType> mTypes;
+    std::unordered_map<std::string, size_t, NameHash, std::equal_to<>> mByName;
+    std::unordered_map<int, size_t> mById;
+};
+
+#endif // TYPEREGISTRY_H
@@ -0,0 +1,49 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "WriteBehindQueue.h"
+#include <utility>
+
+Money WriteBehindQueue::GetPointeeContribution(const PendingPointee& entry) {
+    if (entry.mPointee == entry.mStored.IsPointee()) {
+        return Money();
+    }
+    return entry.mPointee ? entry.mSignedAmount : -entry.mSignedAmount;
+}
+
+void WriteBehindQueue::QueuePointee(Transaction stored, Money signedAmount,
+                                    bool pointee, const wxDateTime& datePointee) {
+    auto it = mEntries.find(stored.GetId());
+    if (it != mEntries.end()) {
+        mPointeeDelta -= GetPointeeContribution(it->second);
+        mEntries.erase(it);
+    }
+
+    // Retour à l'état enregistré : plus rien à écrire
+    if (pointee == stored.IsPointee()) {
+        return;
+    }
+
+    const int id = stored.GetId();
+    PendingPointee entry{std::move(stored), signedAmount, pointee, pointee ? datePointee : wxDateTime()};
+    mPointeeDelta += GetPointeeContribution(entry);
+    mEntries.emplace(id, std::move(entry));
+}
+
+const PendingPointee* WriteBehindQueue::Find(int id) const {
+    auto it = mEntries.find(id);
+    return it != mEntries.end() ? &it->second : nullptr;
+}
+
+void WriteBehindQueue::Apply(Transaction& transaction) const {
+    if (const PendingPointee* entry = Find(transaction.GetId())) {
+        transaction.SetPointee(entry->mPointee);
+        transaction.SetDatePointee(entry->mDatePointee);
+    }
+}
+
+void WriteBehindQueue::Clear() {
+    mEntries.clear();
+    mPointeeDelta = Money();
+}
@@ -0,0 +1,53 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef WRITEBEHINDQUEUE_H
+#define WRITEBEHINDQUEUE_H
+
+#include <map>
+#include <wx/datetime.h>
+#include "Money.h"
+#include "Transaction.h"
+
+// Pointage en attente d'écriture pour une transaction
+struct PendingPointee {
+    Transaction mStored;   // Ligne telle qu'enregistrée en base
+    Money mSignedAmount;   // Contribution de la ligne aux totaux (selon son type)
+    bool mPointee;
+    wxDateTime mDatePointee;
+};
+
+// File d'écritures différées du rapprochement : les changements de pointage
+// sont visibles immédiatement en mémoire, les bascules répétées d'une même
+// transaction fusionnent, et Database les écrit ensuite en une seule transaction.
+//
+// Garantie : rien n'est durable avant FlushPendingWrites. L'interface écrit la
+// file 2 s après la dernière case cochée, au plus tard 10 s après la première
+// case en attente, avant toute autre écriture et à la fermeture de la base.
+// Un arrêt brutal perd donc au plus les 10 dernières secondes de pointage.
+class WriteBehindQueue {
+public:
+    // Enregistre le nouvel état pointé ; revenir à l'état en base annule l'entrée
+    void QueuePointee(Transaction stored, Money signedAmount,
+                      bool pointee, const wxDateTime& datePointee);
+
+    const PendingPointee* Find(int id) const;
+    // Applique l'éventuel pointage en attente à une ligne lue en base
+    void Apply(Transaction& transaction) const;
+
+    const std::map<int, PendingPointee>& GetEntries() const { return mEntries; }
+    // Variation du total pointé non encore écrite en base
+    Money GetPointeeDelta() const { return mPointeeDelta; }
+    bool IsEmpty() const { return mEntries.empty(); }
+    size_t GetCount() const { return mEntries.size(); }
+    void Clear();
+
+private:
+    static Money GetPointeeContribution(const PendingPointee& entry);
+
+    std::map<int, PendingPointee> mEntries;  // Par id : écriture dans l'ordre des clés
+    Money mPointeeDelta;
+};
+
+#endif // WRITEBEHINDQUEUE_H
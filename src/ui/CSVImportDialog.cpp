@@ -16,7 +16,7 @@ wxBEGIN_EVENT_TABLE(CSVImportDialog, wxDialog)
     EVT_BUTTON(wxID_CANCEL, CSVImportDialog::OnCancel)
 wxEND_EVENT_TABLE()
 
-CSVImportDialog::CSVImportDialog(wxWindow* parent, Database* database,
+CSVImportDialog::CSVImportDialog(wxWindow* parent, AsyncDatabase* database,
                                  const std::vector<std::string>& csvHeaders,
                                  const std::vector<std::vector<std::string>>& csvData)
     : wxDialog(parent, wxID_ANY, "Importation CSV - Mapping des champs",
@@ -95,7 +95,7 @@ void CSVImportDialog::CreateControls() {
     // Type par défaut
     gridSizer->Add(new wxStaticText(this, wxID_ANY, "Type par défaut:"), 0, wxALIGN_CENTER_VERTICAL);
     mDefaultTypeChoice = new wxChoice(this, wxID_ANY);
-    auto types = mDatabase->GetAllTypes();
+    const auto& types = mDatabase->GetTypeRegistry().GetTypes();
     for (const auto& type : types) {
         wxString displayName = type.mNom + (type.mIsDepense ? " (Dépense)" : " (Recette)");
         mDefaultTypeChoice->Append(displayName, new wxStringClientData(type.mNom));
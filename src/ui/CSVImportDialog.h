@@ -9,11 +9,11 @@
 #include <wx/choice.h>
 #include <vector>
 #include <string>
-#include <core/Database.h>
+#include <core/AsyncDatabase.h>
 
 class CSVImportDialog : public wxDialog {
 public:
-    CSVImportDialog(wxWindow* parent, Database* database,
+    CSVImportDialog(wxWindow* parent, AsyncDatabase* database,
                     const std::vector<std::string>& csvHeaders,
                     const std::vector<std::vector<std::string>>& csvData);
 
@@ -37,7 +37,7 @@ private:
     void OnColumnChoiceChanged(wxCommandEvent& event);
     void UpdatePreview();
 
-    Database* mDatabase;
+    AsyncDatabase* mDatabase;
     std::vector<std::string> mCSVHeaders;
     std::vector<std::vector<std::string>> mCSVData;
     FieldMapping mMapping;
@@ -3,25 +3,126 @@
 //
 
 #include "InfoDialog.h"
+#include <wx/notebook.h>
+#include <wx/filedlg.h>
+#include <fstream>
 
-InfoDialog::InfoDialog(wxWindow* parent, Database* database)
+InfoDialog::InfoDialog(wxWindow* parent, AsyncDatabase* database)
     : wxDialog(parent, wxID_ANY, "Informations de la base de données",
-               wxDefaultPosition, wxSize(500, 300)),
-      mDatabase(database) {
+               wxDefaultPosition, wxSize(800, 500), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      mDatabase(database), mProfileList(nullptr) {
 
     wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
 
-    wxTextCtrl* infoText = new wxTextCtrl(this, wxID_ANY, "",
+    wxNotebook* notebook = new wxNotebook(this, wxID_ANY);
+    notebook->AddPage(CreateInfoPage(notebook), "Informations");
+    notebook->AddPage(CreatePerformancePage(notebook), "Performance");
+    mainSizer->Add(notebook, 1, wxALL | wxEXPAND, 10);
+
+    wxButton* closeBtn = new wxButton(this, wxID_CLOSE, "Fermer");
+    mainSizer->Add(closeBtn, 0, wxALL | wxALIGN_CENTER, 10);
+    SetEscapeId(wxID_CLOSE);
+
+    SetSizer(mainSizer);
+    LoadProfile();
+}
+
+wxPanel* InfoDialog::CreateInfoPage(wxWindow* parent) {
+    wxPanel* panel = new wxPanel(parent);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+
+    wxTextCtrl* infoText = new wxTextCtrl(panel, wxID_ANY, "",
                                            wxDefaultPosition, wxDefaultSize,
                                            wxTE_MULTILINE | wxTE_READONLY);
 
-    wxString info = mDatabase->GetDatabaseInfo();
+    wxString info = mDatabase->Call(&Database::GetDatabaseInfo);
     infoText->SetValue(info);
 
-    mainSizer->Add(infoText, 1, wxALL | wxEXPAND, 10);
+    sizer->Add(infoText, 1, wxALL | wxEXPAND, 5);
+    panel->SetSizer(sizer);
+    return panel;
+}
 
-    wxButton* closeBtn = new wxButton(this, wxID_CLOSE, "Fermer");
-    mainSizer->Add(closeBtn, 0, wxALL | wxALIGN_CENTER, 10);
+wxPanel* InfoDialog::CreatePerformancePage(wxWindow* parent) {
+    wxPanel* panel = new wxPanel(parent);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
 
-    SetSizer(mainSizer);
-}
\ No newline at end of file
+    // Une ligne par requête normalisée, les plus coûteuses en premier
+    mProfileList = new wxListCtrl(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                  wxLC_REPORT | wxLC_SINGLE_SEL);
+    mProfileList->AppendColumn("Requête", wxLIST_FORMAT_LEFT, 330);
+    mProfileList->AppendColumn("Appels", wxLIST_FORMAT_RIGHT, 65);
+    mProfileList->AppendColumn("Lignes", wxLIST_FORMAT_RIGHT, 70);
+    mProfileList->AppendColumn("Instructions", wxLIST_FORMAT_RIGHT, 90);
+    mProfileList->AppendColumn("Total (ms)", wxLIST_FORMAT_RIGHT, 80);
+    mProfileList->AppendColumn("p50 (ms)", wxLIST_FORMAT_RIGHT, 70);
+    mProfileList->AppendColumn("p99 (ms)", wxLIST_FORMAT_RIGHT, 70);
+    mProfileList->AppendColumn("Max (ms)", wxLIST_FORMAT_RIGHT, 70);
+    sizer->Add(mProfileList, 1, wxALL | wxEXPAND, 5);
+
+    wxBoxSizer* buttonSizer = new wxBoxSizer(wxHORIZONTAL);
+    wxButton* refreshBtn = new wxButton(panel, wxID_ANY, "Actualiser");
+    wxButton* resetBtn = new wxButton(panel, wxID_ANY, "Réinitialiser");
+    wxButton* exportBtn = new wxButton(panel, wxID_ANY, "Exporter en JSON...");
+    buttonSizer->Add(refreshBtn, 0, wxRIGHT, 5);
+    buttonSizer->Add(resetBtn, 0, wxRIGHT, 5);
+    buttonSizer->Add(exportBtn, 0);
+    sizer->Add(buttonSizer, 0, wxALL | wxALIGN_RIGHT, 5);
+
+    refreshBtn->Bind(wxEVT_BUTTON, &InfoDialog::OnRefreshProfile, this);
+    resetBtn->Bind(wxEVT_BUTTON, &InfoDialog::OnResetProfile, this);
+    exportBtn->Bind(wxEVT_BUTTON, &InfoDialog::OnExportProfile, this);
+
+    panel->SetSizer(sizer);
+    return panel;
+}
+
+void InfoDialog::LoadProfile() {
+    // Profil commun à la connexion d'écriture et aux connexions de lecture
+    mProfile = mDatabase->Call(&Database::GetSqlProfile);
+
+    auto toMs = [](std::chrono::nanoseconds duration) {
+        return wxString::Format("%.3f", duration.count() / 1e6);
+    };
+
+    mProfileList->Freeze();
+    mProfileList->DeleteAllItems();
+    for (size_t i = 0; i < mProfile.size(); ++i) {
+        const SqlProfileEntry& entry = mProfile[i];
+        long item = mProfileList->InsertItem(static_cast<long>(i), wxString::FromUTF8(entry.mSql));
+        mProfileList->SetItem(item, 1, wxString::Format("%llu", static_cast<unsigned long long>(entry.mCalls)));
+        mProfileList->SetItem(item, 2, wxString::Format("%llu", static_cast<unsigned long long>(entry.mRows)));
+        mProfileList->SetItem(item, 3, wxString::Format("%llu", static_cast<unsigned long long>(entry.mVmSteps)));
+        mProfileList->SetItem(item, 4, toMs(entry.mTotalTime));
+        mProfileList->SetItem(item, 5, toMs(entry.mP50));
+        mProfileList->SetItem(item, 6, toMs(entry.mP99));
+        mProfileList->SetItem(item, 7, toMs(entry.mMax));
+    }
+    mProfileList->Thaw();
+}
+
+void InfoDialog::OnRefreshProfile(wxCommandEvent& event) {
+    LoadProfile();
+}
+
+void InfoDialog::OnResetProfile(wxCommandEvent& event) {
+    mDatabase->Call(&Database::ResetSqlProfile);
+    LoadProfile();
+}
+
+void InfoDialog::OnExportProfile(wxCommandEvent& event) {
+    wxFileDialog saveFileDialog(this, "Exporter le profil SQL", "",
+                                "profil_sql.json",
+                                "Fichiers JSON (*.json)|*.json",
+                                wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (saveFileDialog.ShowModal() == wxID_CANCEL) {
+        return;
+    }
+
+    std::ofstream file(saveFileDialog.GetPath().ToStdString());
+    file << SqlProfiler::ToJson(mProfile);
+    file.close();
+    if (!file) {
+        wxMessageBox("Impossible d'écrire le fichier", "Erreur", wxOK | wxICON_ERROR);
+    }
+}
@@ -6,14 +6,26 @@
 #define INFODIALOG_H
 
 #include <wx/wx.h>
-#include <core/Database.h>
+#include <wx/listctrl.h>
+#include <core/AsyncDatabase.h>
 
 class InfoDialog : public wxDialog {
 public:
-    InfoDialog(wxWindow* parent, Database* database);
+    InfoDialog(wxWindow* parent, AsyncDatabase* database);
 
 private:
-    Database* mDatabase;
+    wxPanel* CreateInfoPage(wxWindow* parent);
+    wxPanel* CreatePerformancePage(wxWindow* parent);
+    // Relit le profil SQL et remplit la liste
+    void LoadProfile();
+
+    void OnRefreshProfile(wxCommandEvent& event);
+    void OnResetProfile(wxCommandEvent& event);
+    void OnExportProfile(wxCommandEvent& event);
+
+    AsyncDatabase* mDatabase;
+    wxListCtrl* mProfileList;
+    std::vector<SqlProfileEntry> mProfile;
 };
 
-#endif // INFODIALOG_H
\ No newline at end of file
+#endif // INFODIALOG_H
@@ -10,56 +10,153 @@
 #include <wx/datectrl.h>
 #include <wx/progdlg.h>
 #include <wx/srchctrl.h>
+#include <wx/tokenzr.h>
 #include <wx/wfstream.h>
 #include <wx/zipstrm.h>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <sstream>
+#include <tuple>
 
 #include "RecurringDialog.h"
+#include "RecurringPreviewDialog.h"
 #include "core/version.h"
 #include "core/Settings.h"
+#include "core/DayNumber.h"
 #include "core/LanguageManager.h"
 
+namespace {
+// Délai d'écriture des pointages après la dernière case cochée
+constexpr int kPointeeFlushDelayMs = 2000;
+// Attente maximale d'un pointage, même si les cases sont cochées sans pause
+constexpr std::chrono::milliseconds kPointeeMaxDelay(10000);
+// Au-delà, un rafraîchissement relit toute la liste
+constexpr size_t kMaxIncrementalChanges = 200;
+// Transactions affichées avant la fin du premier chargement
+constexpr size_t kFirstPageSize = 200;
+// Un identifiant de menu par compte
+constexpr size_t kMaxAccounts = ID_ACCOUNT_LAST - ID_ACCOUNT_FIRST + 1;
+
+// Ordre de chargement de la liste (GetAllTransactions) : la plus récente d'abord
+bool IsInLoadOrder(const Transaction& a, const Transaction& b) {
+    if (a.GetDate() != b.GetDate()) {
+        return a.GetDate() > b.GetDate();
+    }
+    return a.GetId() > b.GetId();
+}
+}
+
+// Format d'un export CSV, copié par valeur : l'export complet l'utilise depuis
+// le thread des rapports, sans lire Settings ni les traductions
+struct MainFrame::CsvFormat {
+    char mSeparator = ';';
+    wxString mDateFormat = "%d/%m/%Y";
+    bool mUseQuotes = true;
+    bool mIncludeSign = false;
+    Settings::DisplayFormat mDisplay{};
+    wxString mYes;
+    wxString mNo;
+    // Ligne d'en-tête déjà échappée, vide si elle n'est pas demandée
+    std::string mHeader;
+
+    // Échappe un champ si nécessaire
+    std::string Escape(const wxString& field) const {
+        std::string result = field.ToStdString();
+        if (mUseQuotes || result.find(mSeparator) != std::string::npos || 
+            result.find('"') != std::string::npos || result.find('\n') != std::string::npos) {
+            // Doubler les guillemets existants
+            size_t pos = 0;
+            while ((pos = result.find('"', pos)) != std::string::npos) {
+                result.insert(pos, "\"");
+                pos += 2;
+            }
+            result = "\"" + result + "\"";
+        }
+        return result;
+    }
+
+    // Écrit une transaction
+    void WriteRow(std::ostream& out, const TypeRegistry& types, const wxDateTime& date,
+                  std::string_view libelle, Money somme, int typeId, bool pointee,
+                  const wxDateTime& datePointee) const {
+        // Date
+        out << Escape(date.Format(mDateFormat)) << mSeparator;
+        
+        // Libellé
+        out << Escape(wxString(libelle.data(), libelle.size())) << mSeparator;
+        
+        // Montant
+        wxString montantStr;
+        bool isDepense = types.IsDepense(typeId);
+        if (mIncludeSign) {
+            montantStr = (isDepense ? "-" : "+") + mDisplay.FormatMoney(somme);
+        } else {
+            montantStr = mDisplay.FormatMoney(somme);
+            if (isDepense) {
+                montantStr = "-" + montantStr;
+            }
+        }
+        out << Escape(montantStr) << mSeparator;
+        
+        // Type
+        const std::string& type = types.GetName(typeId);
+        out << Escape(wxString(type.data(), type.size())) << mSeparator;
+        
+        // Pointée
+        out << Escape(pointee ? mYes : mNo) << mSeparator;
+        
+        // Date pointée
+        if (pointee && datePointee.IsValid()) {
+            out << Escape(datePointee.Format(mDateFormat));
+        }
+        
+        out << "\n";
+    }
+};
+
 wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_MENU(wxID_EXIT, MainFrame::OnQuit)
     EVT_MENU(ID_PREFERENCES, MainFrame::OnPreferences)
     EVT_MENU(ID_INFO, MainFrame::OnInfo)
+    EVT_MENU(ID_VERIFY_BALANCES, MainFrame::OnVerifyBalances)
     EVT_MENU(ID_IMPORT_CSV, MainFrame::OnImportCSV)
     EVT_MENU(ID_EXPORT_CSV, MainFrame::OnExportCSV)
+    EVT_MENU(ID_EXPORT_REPORT, MainFrame::OnExportReport)
     EVT_MENU(ID_BACKUP, MainFrame::OnBackup)
     EVT_MENU(wxID_ABOUT, MainFrame::OnAbout)
     EVT_MENU(ID_ADD_TRANSACTION, MainFrame::OnAddTransaction)
     EVT_MENU(ID_RAPPROCHEMENT, MainFrame::OnRapprochement)
     EVT_MENU(ID_HIDE_POINTEES, MainFrame::OnToggleHidePointees)
     EVT_MENU(ID_MANAGE_RECURRING, MainFrame::OnManageRecurring)
+    EVT_MENU(ID_CONSOLIDATED_SUMMARY, MainFrame::OnConsolidatedSummary)
+    EVT_MENU(ID_ADD_ACCOUNT, MainFrame::OnAddAccount)
+    EVT_MENU(ID_REMOVE_ACCOUNT, MainFrame::OnRemoveAccount)
+    EVT_MENU_RANGE(ID_ACCOUNT_FIRST, ID_ACCOUNT_LAST, MainFrame::OnSelectAccount)
     EVT_UPDATE_UI(ID_HIDE_POINTEES, MainFrame::OnUpdateToggleHidePointees)
     EVT_LIST_ITEM_RIGHT_CLICK(ID_TRANSACTION_LIST, MainFrame::OnTransactionRightClick)
     EVT_LIST_COL_CLICK(ID_TRANSACTION_LIST, MainFrame::OnColumnClick)
     EVT_LIST_ITEM_CHECKED(ID_TRANSACTION_LIST, MainFrame::OnRapprochementItemChecked)
     EVT_LIST_ITEM_UNCHECKED(ID_TRANSACTION_LIST, MainFrame::OnRapprochementItemChecked)
     EVT_LIST_ITEM_ACTIVATED(ID_TRANSACTION_LIST, MainFrame::OnTransactionDoubleClick)
+    EVT_TIMER(ID_FLUSH_TIMER, MainFrame::OnFlushTimer)
 wxEND_EVENT_TABLE()
 
 MainFrame::MainFrame(const wxString& title)
     : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(900, 600)),
-        mSommeEnLigne(0.0), mSortColumn(-1), mSortAscending(true), mSearchText(""),
-        mRapprochementMode(false), mHidePointees(false) {
+        mAccountsMenu(nullptr), mSommeEnLigne(), mSortColumn(-1), mSortAscending(true), mPendingLoads(0), mDataVersion(0), mDatabaseGeneration(0), mSearchText(""), mSearchUsesIndex(false), mPendingSearches(0),
+        mRapprochementMode(false), mFlushTimer(this, ID_FLUSH_TIMER), mHidePointees(false) {
 
     // Initialiser le gestionnaire de langues
     LanguageManager::GetInstance().Initialize(this);
 
-    mDatabase = std::make_unique<Database>("mescomptes.db");
-    if (!mDatabase->Open()) {
+    Settings& settings = Settings::GetInstance();
+    mAccounts.Load(settings.GetAccounts());
+    if (!OpenDatabase(settings.GetDatabasePath())) {
         wxMessageBox(_("Error opening database"),
                      _("Error"), wxOK | wxICON_ERROR);
     }
-    
-    // Exécuter les transactions récurrentes en attente
-    int executedCount = mDatabase->ExecutePendingRecurringTransactions();
-    if (executedCount > 0) {
-        wxMessageBox(wxString::Format("%d transaction(s) récurrente(s) ajoutée(s)", executedCount),
-                    "Transactions récurrentes", wxOK | wxICON_INFORMATION);
-    }
+    CheckPendingRecurring();
 
     // Définir l'icône de l'application
     wxIcon icon("res/icon.png", wxBITMAP_TYPE_PNG);
@@ -74,9 +171,57 @@ MainFrame::MainFrame(const wxString& title)
 }
 
 MainFrame::~MainFrame() {
-    if (mDatabase) {
-        mDatabase->Close();
+    mFlushTimer.Stop();
+    // La lecture des comptes en cours rappelle la fenêtre : attendre sa fin
+    if (mSummaryTask.valid()) {
+        mSummaryTask.wait();
     }
+    // La destruction de mDatabase termine les requêtes en file puis ferme
+    // la base, ce qui écrit aussi les pointages encore en attente
+}
+
+bool MainFrame::OpenDatabase(const std::string& path) {
+    Settings& settings = Settings::GetInstance();
+    // La base vit sur son propre thread ; les résultats reviennent par CallAfter.
+    // L'ancienne base éventuelle est fermée avant l'ouverture de la nouvelle.
+    mDatabase.reset();
+
+    // Les requêtes de l'ancienne base ont été exécutées par sa fermeture, mais
+    // leurs coroutines reprendront plus tard : la génération les fait ignorer
+    ++mDatabaseGeneration;
+    mPendingLoads = 0;
+    mPendingSearches = 0;
+    mDataVersion = 0;
+
+    mDatabase = std::make_unique<AsyncDatabase>(
+        std::make_unique<Database>(path, settings.GetConnectionProfile()),
+        [this](std::function<void()> callback) { CallAfter(std::move(callback)); });
+    return mDatabase->Call(&Database::Open);
+}
+
+void MainFrame::CheckPendingRecurring() {
+    // Rechercher les échéances récurrentes manquées, sans bloquer l'ouverture,
+    // et les proposer en aperçu avant de les ajouter toutes d'un coup
+    mDatabase->Submit([](Database& db) { return db.GetPendingRecurringOccurrences(); },
+                      [this, generation = mDatabaseGeneration](std::vector<RecurringOccurrence> occurrences) {
+        // Rien à faire si un autre compte a été ouvert entre-temps
+        if (occurrences.empty() || generation != mDatabaseGeneration) {
+            return;
+        }
+
+        RecurringPreviewDialog dialog(this, mDatabase.get(), occurrences);
+        if (dialog.ShowModal() != wxID_OK) {
+            return;
+        }
+
+        if (mDatabase->Call(&Database::ApplyRecurringOccurrences, occurrences) < 0) {
+            wxMessageBox("Erreur lors de l'ajout des transactions récurrentes",
+                         "Transactions récurrentes", wxOK | wxICON_ERROR);
+            return;
+        }
+        RefreshTransactions();
+        UpdateSummary();
+    });
 }
 
 void MainFrame::CreateMenuBar() {
@@ -94,12 +239,14 @@ void MainFrame::CreateMenuBar() {
                             _("Import transactions from a CSV file"));
     menuImportExport->Append(ID_EXPORT_CSV, _("&Export to CSV\tCtrl-E"),
                             _("Export transactions to a CSV file"));
+    menuImportExport->Append(ID_EXPORT_REPORT, _("Export &Report..."),
+                            _("Export a readable text report of the account"));
     menuFile->AppendSubMenu(menuImportExport, _("&Import/Export"), 
                            _("Import or export data"));
     
     menuFile->AppendSeparator();
     menuFile->Append(ID_BACKUP, _("&Backup Account\tCtrl-S"),
-                     _("Create a compressed backup of the account"));
+                     _("Create a restorable copy of the account database"));
     menuFile->AppendSeparator();
     menuFile->Append(ID_MANAGE_RECURRING, _("Manage &Recurring\tCtrl-T"),
                      _("Manage recurring transactions"));
@@ -110,6 +257,19 @@ void MainFrame::CreateMenuBar() {
     menuFile->Append(wxID_EXIT, _("&Quit\tCtrl-Q"), _("Quit the application"));
     menuBar->Append(menuFile, _("&File"));
 
+    // Menu Comptes : synthèse de tous les comptes et changement de compte
+    mAccountsMenu = new wxMenu;
+    mAccountsMenu->Append(ID_CONSOLIDATED_SUMMARY, _("&Consolidated Summary\tCtrl-Shift-C"),
+                          _("Show the combined balance of all accounts"));
+    mAccountsMenu->AppendSeparator();
+    mAccountsMenu->Append(ID_ADD_ACCOUNT, _("&Add Account..."),
+                          _("Open or create another account file"));
+    mAccountsMenu->Append(ID_REMOVE_ACCOUNT, _("&Remove Account..."),
+                          _("Remove an account from the list without deleting its file"));
+    mAccountsMenu->AppendSeparator();
+    menuBar->Append(mAccountsMenu, _("&Accounts"));
+    UpdateAccountsMenu();
+
     // Menu Affichage
     wxMenu* menuView = new wxMenu;
     menuView->AppendCheckItem(ID_HIDE_POINTEES, _("&Hide Checked Transactions\tCtrl-H"),
@@ -126,6 +286,8 @@ void MainFrame::CreateMenuBar() {
     wxMenu* menuInfo = new wxMenu;
     menuInfo->Append(ID_INFO, _("&Database Info\tCtrl-I"),
                      _("Show database information"));
+    menuInfo->Append(ID_VERIFY_BALANCES, _("&Verify Balances"),
+                     _("Recompute the totals from all transactions and report any difference"));
     menuBar->Append(menuInfo, _("&Information"));
 
     // Menu Aide
@@ -180,6 +342,7 @@ void MainFrame::CreateControls() {
     mTransactionList->AppendColumn(_("Checked"), wxLIST_FORMAT_CENTER, 80);
     mTransactionList->AppendColumn(_("Check Date"), wxLIST_FORMAT_LEFT, 120);
     mTransactionList->AppendColumn(_("Type"), wxLIST_FORMAT_LEFT, 120);
+    mTransactionList->AppendColumn(_("Balance"), wxLIST_FORMAT_RIGHT, 110);
 
     mainSizer->Add(mTransactionList, 1, wxALL | wxEXPAND, 5);
 
@@ -220,12 +383,179 @@ void MainFrame::CreateControls() {
     panel->SetSizer(mainSizer);
 }
 
-void MainFrame::LoadTransactions() {
-    mTransactionList->DeleteAllItems();
+DetachedTask MainFrame::LoadTransactions() {
+    // Seul le dernier chargement demandé met à jour la liste
+    const uint64_t generation = mDatabaseGeneration;
+    ++mPendingLoads;
+
+    // Liste vide (démarrage, changement de compte) : les transactions les plus
+    // récentes s'affichent d'abord, lues en une page, avant la liste complète.
+    // La liste complète reste en mémoire : filtre, tri, recherche et
+    // rafraîchissement incrémental travaillent sur mAllTransactions.
+    if (mAllTransactions.empty() && mSearchText.IsEmpty()) {
+        TransactionPage page = co_await mDatabase->Async([](Database& db) {
+            return db.GetTransactionsPage(TransactionSortKey::DATE, false, PageCursor(), kFirstPageSize);
+        });
+        // Résultat d'un compte fermé depuis : les compteurs appartiennent au suivant
+        if (generation != mDatabaseGeneration) {
+            co_return;
+        }
+        if (mPendingLoads == 1 && page.mHasMore) {
+            mAllTransactions = std::move(page.mTransactions);
+            RenderTransactions();
+        }
+    }
+
+    auto [version, transactions, balances] = co_await mDatabase->Async([](Database& db) {
+        auto all = db.GetAllTransactions();
+        auto running = db.GetRunningBalances();
+        return std::make_tuple(db.GetDataVersion(), std::move(all), std::move(running));
+    });
+    if (generation != mDatabaseGeneration || --mPendingLoads > 0) {
+        co_return;
+    }
+
+    mAllTransactions = std::move(transactions);
+    mRunningBalances = std::move(balances);
+    mDataVersion = version;
+    if (mSearchText.IsEmpty()) {
+        RenderTransactions();
+    } else {
+        UpdateSearchMatches();
+    }
+}
+
+DetachedTask MainFrame::RefreshTransactions() {
+    const uint64_t generation = mDatabaseGeneration;
+    ++mPendingLoads;
+    auto readChanges = [since = mDataVersion](Database& db) {
+        ChangeSet changes = db.GetChangesSince(since);
+        std::vector<Transaction> rows;
+        if (!changes.mFullReload && changes.GetCount() <= kMaxIncrementalChanges) {
+            for (const auto* ids : {&changes.mInserted, &changes.mUpdated}) {
+                for (int id : *ids) {
+                    rows.push_back(db.GetTransaction(id));
+                }
+            }
+        }
+        return std::make_pair(std::move(changes), std::move(rows));
+    };
+    auto [changes, rows] = co_await mDatabase->Async(std::move(readChanges));
+    if (generation != mDatabaseGeneration || --mPendingLoads > 0) {
+        co_return;
+    }
+
+    if (changes.mFullReload || changes.GetCount() > kMaxIncrementalChanges) {
+        LoadTransactions();
+        co_return;
+    }
+
+    mDataVersion = changes.mVersion;
+    if (changes.IsEmpty()) {
+        co_return;
+    }
+
+    for (int id : changes.mDeleted) {
+        std::erase_if(mAllTransactions, [id](const Transaction& trans) { return trans.GetId() == id; });
+    }
+    for (auto& row : rows) {
+        auto it = std::find_if(mAllTransactions.begin(), mAllTransactions.end(),
+                               [&row](const Transaction& trans) { return trans.GetId() == row.GetId(); });
+        if (it != mAllTransactions.end()) {
+            *it = std::move(row);
+        } else {
+            mAllTransactions.push_back(std::move(row));
+        }
+    }
+    // Ajouts en fin de liste et dates modifiées : la liste reprend l'ordre
+    // d'un chargement complet, celui de l'affichage sans colonne de tri
+    std::sort(mAllTransactions.begin(), mAllTransactions.end(), IsInLoadOrder);
+
+    // Filtre et tri repartent de la liste en mémoire, sans relire la base
+    if (mSearchText.IsEmpty()) {
+        RenderTransactions();
+    } else {
+        UpdateSearchMatches();
+    }
+
+    // Toute modification décale le solde des transactions suivantes
+    LoadRunningBalances();
+}
 
+DetachedTask MainFrame::LoadRunningBalances() {
+    const uint64_t generation = mDatabaseGeneration;
+    auto balances = co_await mDatabase->Async([](Database& db) { return db.GetRunningBalances(); });
+    // Un chargement complet en cours apportera ses propres soldes
+    if (generation != mDatabaseGeneration || mPendingLoads > 0) {
+        co_return;
+    }
+
+    mRunningBalances = std::move(balances);
     Settings& settings = Settings::GetInstance();
-    mAllTransactions = mDatabase->GetAllTransactions();
-    
+    for (long index = 0; index < mTransactionList->GetItemCount(); ++index) {
+        int id = static_cast<int>(mTransactionList->GetItemData(index));
+        mTransactionList->SetItem(index, 6, FormatRunningBalance(settings, id));
+    }
+}
+
+wxString MainFrame::FormatRunningBalance(const Settings& settings, int id) const {
+    auto it = mRunningBalances.find(id);
+    return it != mRunningBalances.end() ? settings.FormatMoney(it->second) + " €" : wxString();
+}
+
+DetachedTask MainFrame::UpdateSearchMatches() {
+    if (mSearchText.IsEmpty()) {
+        mSearchMatches.clear();
+        mSearchShortWords.clear();
+        mSearchUsesIndex = false;
+        RenderTransactions();
+        co_return;
+    }
+
+    // Les mots trop courts pour l'index sont comparés en mémoire par
+    // FilterTransactions, en minuscules Unicode comme les autres par FTS5
+    std::vector<wxString> shortWords;
+    bool usesIndex = false;
+    wxStringTokenizer tokenizer(mSearchText.Lower(), " \t\r\n");
+    while (tokenizer.HasMoreTokens()) {
+        wxString word = tokenizer.GetNextToken();
+        // Un * final (recherche par préfixe) est ignoré, comme par la base
+        while (word.EndsWith("*")) {
+            word.RemoveLast();
+        }
+        if (word.length() >= Database::kMinSearchWordLength) {
+            usesIndex = true;
+        } else if (!word.IsEmpty()) {
+            shortWords.push_back(word);
+        }
+    }
+
+    // Seule la dernière recherche lancée met à jour la liste
+    const uint64_t generation = mDatabaseGeneration;
+    ++mPendingSearches;
+    std::vector<int> ids;
+    if (usesIndex) {
+        auto search = [query = mSearchText.ToStdString(wxConvUTF8)](Database& db) {
+            return db.SearchTransactions(query, 0);
+        };
+        ids = co_await mDatabase->Async(std::move(search));
+    }
+    if (generation != mDatabaseGeneration || --mPendingSearches > 0) {
+        co_return;
+    }
+
+    mSearchMatches.clear();
+    for (size_t rank = 0; rank < ids.size(); ++rank) {
+        mSearchMatches.emplace(ids[rank], rank);
+    }
+    mSearchShortWords = std::move(shortWords);
+    mSearchUsesIndex = usesIndex;
+    RenderTransactions();
+}
+
+void MainFrame::RenderTransactions() {
+    mTransactionList->DeleteAllItems();
+
     // Appliquer le filtre de recherche
     FilterTransactions();
 
@@ -246,43 +576,102 @@ void MainFrame::LoadTransactions() {
     }
 
     for (size_t i = 0; i < mCachedTransactions.size(); ++i) {
-        const auto& trans = mCachedTransactions[i];
-        long index = mTransactionList->InsertItem(i, settings.FormatDate(trans.GetDate()));
-        mTransactionList->SetItem(index, 1, trans.GetLibelle());
-
-        // Afficher avec signe + ou - selon le type
-        bool isDepense = mDatabase->IsTypeDepense(trans.GetType());
-        wxString sommeStr;
-        if (isDepense) {
-            sommeStr = "-" + settings.FormatMoney(trans.GetSomme());
-            // Rouge pastel (salmon/coral)
-            mTransactionList->SetItemTextColour(index, wxColour(220, 100, 100));
-        } else {
-            sommeStr = "+" + settings.FormatMoney(trans.GetSomme());
-            // Vert pastel
-            mTransactionList->SetItemTextColour(index, wxColour(100, 180, 120));
-        }
+        long index = mTransactionList->InsertItem(i, wxEmptyString);
+        FillTransactionRow(index, mCachedTransactions[i]);
+    }
+}
+
+void MainFrame::FillTransactionRow(long index, const Transaction& trans) {
+    Settings& settings = Settings::GetInstance();
+    mTransactionList->SetItem(index, 0, settings.FormatDate(trans.GetDate()));
+    mTransactionList->SetItem(index, 1, trans.GetLibelle());
+
+    // Afficher avec signe + ou - selon le type
+    bool isDepense = mDatabase->IsTypeDepense(trans.GetTypeId());
+    wxString sommeStr;
+    if (isDepense) {
+        sommeStr = "-" + settings.FormatMoney(trans.GetSomme());
+        // Rouge pastel (salmon/coral)
+        mTransactionList->SetItemTextColour(index, wxColour(220, 100, 100));
+    } else {
+        sommeStr = "+" + settings.FormatMoney(trans.GetSomme());
+        // Vert pastel
+        mTransactionList->SetItemTextColour(index, wxColour(100, 180, 120));
+    }
 
-        mTransactionList->SetItem(index, 2, sommeStr);
-        mTransactionList->SetItem(index, 3, trans.IsPointee() ? _("Yes") : _("No"));
+    mTransactionList->SetItem(index, 2, sommeStr);
+    mTransactionList->SetItem(index, 3, trans.IsPointee() ? _("Yes") : _("No"));
 
-        // Afficher la date pointée si elle existe
-        if (trans.IsPointee() && trans.GetDatePointee().IsValid()) {
-            mTransactionList->SetItem(index, 4, settings.FormatDate(trans.GetDatePointee()));
-        } else {
-            mTransactionList->SetItem(index, 4, "");
+    // Afficher la date pointée si elle existe
+    if (trans.IsPointee() && trans.GetDatePointee().IsValid()) {
+        mTransactionList->SetItem(index, 4, settings.FormatDate(trans.GetDatePointee()));
+    } else {
+        mTransactionList->SetItem(index, 4, "");
+    }
+
+    mTransactionList->SetItem(index, 5, mDatabase->GetTypeRegistry().GetName(trans.GetTypeId()));
+    mTransactionList->SetItem(index, 6, FormatRunningBalance(settings, trans.GetId()));
+    mTransactionList->SetItemData(index, trans.GetId());
+}
+
+void MainFrame::ApplyTransactionDelta(const TransactionDelta& delta) {
+    // Un chargement en cours écraserait la ligne avec l'état précédent
+    if (mPendingLoads > 0) {
+        LoadTransactions();
+        UpdateSummary();
+        return;
+    }
+
+    // Mettre à jour la ligne en mémoire et à l'écran, sans tout recharger
+    const Transaction& trans = delta.mAfter;
+    auto sameId = [&trans](const Transaction& other) { return other.GetId() == trans.GetId(); };
+
+    auto it = std::find_if(mAllTransactions.begin(), mAllTransactions.end(), sameId);
+    if (it != mAllTransactions.end()) {
+        *it = trans;
+    }
+
+    auto cached = std::find_if(mCachedTransactions.begin(), mCachedTransactions.end(), sameId);
+    long index = mTransactionList->FindItem(-1, static_cast<wxUIntPtr>(trans.GetId()));
+
+    // Une transaction pointée disparaît si les pointées sont masquées
+    // (en rapprochement, la ligne reste affichée et cochée)
+    if (mHidePointees && !mRapprochementMode && trans.IsPointee()) {
+        if (cached != mCachedTransactions.end()) {
+            mCachedTransactions.erase(cached);
+        }
+        if (index != wxNOT_FOUND) {
+            mTransactionList->DeleteItem(index);
         }
+    } else {
+        if (cached != mCachedTransactions.end()) {
+            *cached = trans;
+        }
+        if (index != wxNOT_FOUND) {
+            FillTransactionRow(index, trans);
+        }
+    }
 
-        mTransactionList->SetItem(index, 5, trans.GetType());
-        mTransactionList->SetItemData(index, trans.GetId());
+    // Le pointage ne change aucun solde ; la date, la somme ou le type, si
+    if (delta.mBefore.GetDate() != trans.GetDate() || delta.mBefore.GetSomme() != trans.GetSomme() ||
+        delta.mBefore.GetTypeId() != trans.GetTypeId()) {
+        LoadRunningBalances();
     }
+
+    UpdateSummary();
 }
 
-void MainFrame::UpdateSummary() {
+DetachedTask MainFrame::UpdateSummary() {
+    const uint64_t generation = mDatabaseGeneration;
+    auto [restant, pointee] = co_await mDatabase->Async([](Database& db) {
+        return std::make_pair(db.GetTotalRestant(), db.GetTotalPointee());
+    });
+    if (generation != mDatabaseGeneration) {
+        co_return;
+    }
+
     Settings& settings = Settings::GetInstance();
-    double restant = mDatabase->GetTotalRestant();
-    double pointee = mDatabase->GetTotalPointee();
-    double diff = pointee - (restant - mSommeEnLigne);
+    Money diff = pointee - (restant - mSommeEnLigne);
 
     mRestantText->SetValue(settings.FormatMoney(restant) + " €");
     mPointeeText->SetValue(settings.FormatMoney(pointee) + " €");
@@ -296,6 +685,10 @@ void MainFrame::OnQuit(wxCommandEvent& event) {
 void MainFrame::OnPreferences(wxCommandEvent& event) {
     PreferencesDialog dialog(this, mDatabase.get());
     dialog.ShowModal();
+
+    // Un type renommé ou dont le sens a changé modifie l'affichage des lignes
+    RefreshTransactions();
+    UpdateSummary();
 }
 
 void MainFrame::OnInfo(wxCommandEvent& event) {
@@ -303,6 +696,238 @@ void MainFrame::OnInfo(wxCommandEvent& event) {
     dialog.ShowModal();
 }
 
+void MainFrame::OnVerifyBalances(wxCommandEvent& event) {
+    Settings& settings = Settings::GetInstance();
+    BalanceReport report = mDatabase->Call(&Database::RebuildBalances);
+
+    if (report.HasDrift()) {
+        wxMessageBox(wxString::Format(_("The stored totals were out of date and have been rebuilt.\n\n"
+                                        "Remaining: %s € (difference %s €)\n"
+                                        "Checked Total: %s € (difference %s €)"),
+                                      settings.FormatMoney(report.mComputedRestant),
+                                      settings.FormatMoney(report.GetRestantDrift()),
+                                      settings.FormatMoney(report.mComputedPointee),
+                                      settings.FormatMoney(report.GetPointeeDrift())),
+                     _("Verify Balances"), wxOK | wxICON_WARNING, this);
+    } else {
+        wxMessageBox(_("The stored totals match the transactions."),
+                     _("Verify Balances"), wxOK | wxICON_INFORMATION, this);
+    }
+
+    UpdateSummary();
+}
+
+void MainFrame::UpdateAccountsMenu() {
+    for (int id = ID_ACCOUNT_FIRST; id <= ID_ACCOUNT_LAST; ++id) {
+        if (mAccountsMenu->FindItem(id)) {
+            mAccountsMenu->Destroy(id);
+        }
+    }
+
+    const auto& accounts = mAccounts.GetAccounts();
+    const std::string current = Settings::GetInstance().GetDatabasePath();
+    for (size_t i = 0; i < accounts.size() && i < kMaxAccounts; ++i) {
+        wxMenuItem* item = mAccountsMenu->AppendRadioItem(ID_ACCOUNT_FIRST + static_cast<int>(i),
+                                                          wxString::FromUTF8(accounts[i].mName),
+                                                          wxString(accounts[i].mPath));
+        item->Check(AccountRegistry::IsSamePath(accounts[i].mPath, current));
+    }
+}
+
+void MainFrame::SwitchAccount(const Account& account) {
+    Settings& settings = Settings::GetInstance();
+    const std::string previous = settings.GetDatabasePath();
+    if (AccountRegistry::IsSamePath(account.mPath, previous)) {
+        return;
+    }
+
+    if (mRapprochementMode) {
+        ExitRapprochementMode();
+    }
+    mFlushTimer.Stop();
+    mFlushDeadline.reset();
+
+    {
+        wxBusyCursor busy;
+        // La fermeture de l'ancienne base écrit ses pointages en attente
+        if (!OpenDatabase(account.mPath)) {
+            wxMessageBox(_("Error opening database"),
+                         _("Error"), wxOK | wxICON_ERROR);
+            OpenDatabase(previous);
+            UpdateAccountsMenu();
+            LoadTransactions();
+            UpdateSummary();
+            return;
+        }
+    }
+    settings.SetDatabasePath(account.mPath);
+
+    // Rien de l'ancien compte ne doit rester affiché
+    mAllTransactions.clear();
+    mCachedTransactions.clear();
+    mRunningBalances.clear();
+    mSearchMatches.clear();
+    mSearchShortWords.clear();
+    mSearchUsesIndex = false;
+
+    UpdateAccountsMenu();
+    LoadTransactions();
+    UpdateSummary();
+    CheckPendingRecurring();
+    SetStatusText(wxString::Format(_("Account: %s"), wxString::FromUTF8(account.mName)));
+}
+
+void MainFrame::OnSelectAccount(wxCommandEvent& event) {
+    size_t index = static_cast<size_t>(event.GetId() - ID_ACCOUNT_FIRST);
+    const auto& accounts = mAccounts.GetAccounts();
+    if (index < accounts.size()) {
+        SwitchAccount(accounts[index]);
+    }
+}
+
+void MainFrame::OnAddAccount(wxCommandEvent& event) {
+    if (mAccounts.GetAccounts().size() >= kMaxAccounts) {
+        wxMessageBox(wxString::Format(_("At most %zu accounts can be registered."), kMaxAccounts),
+                     _("Add Account"), wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    // Fichier existant ou nouveau
+    wxFileDialog fileDialog(this, _("Add Account"), "", "compte.db",
+                            _("Database files (*.db)|*.db"), wxFD_SAVE);
+    if (fileDialog.ShowModal() == wxID_CANCEL) {
+        return;
+    }
+    wxString path = fileDialog.GetPath();
+
+    wxString name = wxGetTextFromUser(_("Account name:"), _("Add Account"),
+                                      wxFileName(path).GetName(), this);
+    if (name.IsEmpty()) {
+        return;
+    }
+
+    Account account{name.ToUTF8().data(), path.ToStdString()};
+    if (!mAccounts.Add(account)) {
+        wxMessageBox(_("An account with this name or file already exists."),
+                     _("Add Account"), wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    // Crée la base ou la met à jour : la synthèse la lit ensuite en lecture seule
+    {
+        wxBusyCursor busy;
+        Database database(account.mPath, Settings::GetInstance().GetConnectionProfile());
+        if (!database.Open()) {
+            mAccounts.Remove(account.mPath);
+            wxMessageBox(_("Error opening database"),
+                         _("Error"), wxOK | wxICON_ERROR);
+            return;
+        }
+    }
+
+    Settings::GetInstance().SetAccounts(mAccounts.GetAccounts());
+    UpdateAccountsMenu();
+    SwitchAccount(account);
+}
+
+void MainFrame::OnRemoveAccount(wxCommandEvent& event) {
+    // Le compte ouvert ne peut pas être retiré
+    const std::string current = Settings::GetInstance().GetDatabasePath();
+    std::vector<Account> removable;
+    wxArrayString choices;
+    for (const auto& account : mAccounts.GetAccounts()) {
+        if (!AccountRegistry::IsSamePath(account.mPath, current)) {
+            removable.push_back(account);
+            choices.Add(wxString::FromUTF8(account.mName));
+        }
+    }
+    if (removable.empty()) {
+        wxMessageBox(_("The open account cannot be removed."),
+                     _("Remove Account"), wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+
+    int index = wxGetSingleChoiceIndex(_("Account to remove (its file is kept):"),
+                                       _("Remove Account"), choices, this);
+    if (index < 0) {
+        return;
+    }
+
+    mAccounts.Remove(removable[index].mPath);
+    Settings::GetInstance().SetAccounts(mAccounts.GetAccounts());
+    UpdateAccountsMenu();
+}
+
+void MainFrame::OnConsolidatedSummary(wxCommandEvent& event) {
+    // Une seule lecture à la fois
+    if (mSummaryTask.valid() &&
+        mSummaryTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    // Les totaux sont lus sur disque : y écrire d'abord les pointages en attente
+    FlushPendingPointees();
+
+    // Chaque compte peut attendre jusqu'au délai de verrouillage si un autre
+    // programme y écrit : la lecture se fait hors du thread de l'interface,
+    // sur une copie de la liste, et le dialogue s'ouvre à son retour
+    SetStatusText(_("Reading accounts..."));
+    mSummaryTask = std::async(std::launch::async,
+                              [this, accounts = mAccounts,
+                               busyTimeoutMs = Settings::GetInstance().GetConnectionProfile().mBusyTimeoutMs]() {
+        ConsolidatedSummary summary = accounts.Summarize(busyTimeoutMs);
+        CallAfter([this, summary = std::move(summary)]() { ShowConsolidatedSummary(summary); });
+    });
+}
+
+void MainFrame::ShowConsolidatedSummary(const ConsolidatedSummary& summary) {
+    Settings& settings = Settings::GetInstance();
+    SetStatusText(wxEmptyString);
+
+    wxDialog dialog(this, wxID_ANY, _("Consolidated Summary"), wxDefaultPosition, wxSize(600, 350),
+                    wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+
+    wxListCtrl* list = new wxListCtrl(&dialog, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                      wxLC_REPORT | wxLC_SINGLE_SEL);
+    list->AppendColumn(_("Account"), wxLIST_FORMAT_LEFT, 200);
+    list->AppendColumn(_("Transactions"), wxLIST_FORMAT_RIGHT, 100);
+    list->AppendColumn(_("Remaining"), wxLIST_FORMAT_RIGHT, 130);
+    list->AppendColumn(_("Checked Total"), wxLIST_FORMAT_RIGHT, 130);
+
+    long row = 0;
+    for (const auto& account : summary.mAccounts) {
+        long item = list->InsertItem(row++, wxString::FromUTF8(account.mAccount.mName));
+        if (account.mOk) {
+            list->SetItem(item, 1, wxString::Format("%d", account.mTransactionCount));
+            list->SetItem(item, 2, settings.FormatMoney(account.mRestant) + " €");
+            list->SetItem(item, 3, settings.FormatMoney(account.mPointee) + " €");
+        } else {
+            list->SetItem(item, 2, wxString::FromUTF8(account.mError));
+            list->SetItemTextColour(item, *wxRED);
+        }
+    }
+    long total = list->InsertItem(row, _("Total"));
+    list->SetItem(total, 1, wxString::Format("%d", summary.mTransactionCount));
+    list->SetItem(total, 2, settings.FormatMoney(summary.mRestant) + " €");
+    list->SetItem(total, 3, settings.FormatMoney(summary.mPointee) + " €");
+    wxFont bold = list->GetFont();
+    bold.SetWeight(wxFONTWEIGHT_BOLD);
+    list->SetItemFont(total, bold);
+    sizer->Add(list, 1, wxALL | wxEXPAND, 10);
+
+    wxString footer = wxString::Format(_("%zu account(s) read in %.1f ms"),
+                                       summary.mAccounts.size(), summary.mElapsed.count() / 1e6);
+    if (size_t failed = summary.GetFailedCount()) {
+        footer += wxString::Format(_(", %zu not included in the total"), failed);
+    }
+    sizer->Add(new wxStaticText(&dialog, wxID_ANY, footer), 0, wxLEFT | wxRIGHT, 10);
+    sizer->Add(dialog.CreateStdDialogButtonSizer(wxOK), 0, wxALL | wxALIGN_RIGHT, 10);
+
+    dialog.SetSizer(sizer);
+    dialog.ShowModal();
+}
+
 void MainFrame::ShowTransactionDialog(Transaction* existingTransaction) {
     bool isEdit = (existingTransaction != nullptr);
     bool isReadOnly = isEdit && existingTransaction->IsPointee();
@@ -339,7 +964,7 @@ void MainFrame::ShowTransactionDialog(Transaction* existingTransaction) {
     wxTextCtrl* sommeText = new wxTextCtrl(&dialog, wxID_ANY, "", wxDefaultPosition,
                                             wxDefaultSize, isReadOnly ? wxTE_READONLY : 0);
     if (isEdit) {
-        sommeText->SetValue(wxString::Format("%.2f", existingTransaction->GetSomme()));
+        sommeText->SetValue(existingTransaction->GetSomme().ToString());
     }
     gridSizer->Add(sommeText, 1, wxEXPAND);
 
@@ -355,7 +980,7 @@ void MainFrame::ShowTransactionDialog(Transaction* existingTransaction) {
     // Type
     gridSizer->Add(new wxStaticText(&dialog, wxID_ANY, _("Type:")), 0, wxALIGN_CENTER_VERTICAL);
     wxChoice* typeChoice = new wxChoice(&dialog, wxID_ANY);
-    auto types = mDatabase->GetAllTypes();
+    const auto& types = mDatabase->GetTypeRegistry().GetTypes();
     int selectedIndex = 0;
     for (size_t i = 0; i < types.size(); ++i) {
         wxString displayName = types[i].mNom + (types[i].mIsDepense ? 
@@ -363,7 +988,7 @@ void MainFrame::ShowTransactionDialog(Transaction* existingTransaction) {
             wxString(" (") + _("Income") + ")");
         typeChoice->Append(displayName, new wxStringClientData(types[i].mNom));
 
-        if (isEdit && types[i].mNom == existingTransaction->GetType()) {
+        if (isEdit && types[i].mId == existingTransaction->GetTypeId()) {
             selectedIndex = i;
         }
     }
@@ -402,9 +1027,8 @@ void MainFrame::ShowTransactionDialog(Transaction* existingTransaction) {
         trans.SetDate(datePicker->GetValue());
         trans.SetLibelle(libelleText->GetValue().ToStdString());
 
-        double somme;
-        if (sommeText->GetValue().ToDouble(&somme)) {
-            trans.SetSomme(somme);
+        if (auto somme = Money::Parse(sommeText->GetValue().ToStdString())) {
+            trans.SetSomme(*somme);
         }
 
         trans.SetPointee(pointeeCheck->GetValue());
@@ -413,17 +1037,17 @@ void MainFrame::ShowTransactionDialog(Transaction* existingTransaction) {
         wxStringClientData* data = static_cast<wxStringClientData*>(
             typeChoice->GetClientObject(typeChoice->GetSelection())
         );
-        trans.SetType(data->GetData().ToStdString());
+        trans.SetTypeId(mDatabase->GetTypeRegistry().GetId(data->GetData().ToStdString()));
 
         bool success = false;
         if (isEdit) {
-            success = mDatabase->UpdateTransaction(trans);
+            success = mDatabase->Call(&Database::UpdateTransaction, trans);
         } else {
-            success = mDatabase->AddTransaction(trans);
+            success = mDatabase->Call(&Database::AddTransaction, trans);
         }
 
         if (success) {
-            LoadTransactions();
+            RefreshTransactions();
             UpdateSummary();
         } else {
             wxMessageBox(isEdit ? _("Error updating transaction")
@@ -448,8 +1072,8 @@ void MainFrame::OnDeleteTransaction(wxCommandEvent& event) {
 
     if (wxMessageBox(_("Are you sure you want to delete this transaction?"),
                      _("Confirmation"), wxYES_NO | wxICON_QUESTION) == wxYES) {
-        if (mDatabase->DeleteTransaction(transactionId)) {
-            LoadTransactions();
+        if (mDatabase->Call(&Database::DeleteTransaction, transactionId)) {
+            RefreshTransactions();
             UpdateSummary();
         } else {
             wxMessageBox(_("Error deleting transaction"),
@@ -462,9 +1086,9 @@ void MainFrame::OnManageRecurring(wxCommandEvent& event) {
     RecurringDialog dialog(this, mDatabase.get());
     dialog.ShowModal();
 
-    // Recharger les transactions après la fermeture du dialogue
+    // Relire les transactions modifiées pendant le dialogue
     // (au cas où des transactions récurrentes auraient été exécutées)
-    LoadTransactions();
+    RefreshTransactions();
     UpdateSummary();
 }
 
@@ -476,33 +1100,21 @@ void MainFrame::OnTogglePointee(wxCommandEvent& event) {
     }
 
     int transactionId = mTransactionList->GetItemData(selectedItem);
-    auto transactions = mDatabase->GetAllTransactions();
-
-    for (auto& trans : transactions) {
-        if (trans.GetId() == transactionId) {
-            bool newPointeeStatus = !trans.IsPointee();
-            trans.SetPointee(newPointeeStatus);
-
-            // Si on pointe la transaction, enregistrer la date actuelle
-            if (newPointeeStatus) {
-                trans.SetDatePointee(wxDateTime::Now());
-            } else {
-                // Si on dépointe, réinitialiser la date pointée
-                trans.SetDatePointee(wxDateTime());
-            }
+    Transaction trans = mDatabase->Call(&Database::GetTransaction, transactionId);
+    if (trans.GetId() != transactionId) {
+        return;
+    }
 
-            mDatabase->UpdateTransaction(trans);
-            LoadTransactions();
-            UpdateSummary();
-            break;
-        }
+    // Si on pointe la transaction, enregistrer la date du jour
+    if (auto delta = mDatabase->Call(&Database::SetPointee, transactionId,
+                                      !trans.IsPointee(), wxDateTime::Today())) {
+        ApplyTransactionDelta(*delta);
     }
 }
 
 void MainFrame::OnSommeEnLigneChanged(wxCommandEvent& event) {
-    double somme;
-    if (mSommeEnLigneText->GetValue().ToDouble(&somme)) {
-        mSommeEnLigne = somme;
+    if (auto somme = Money::Parse(mSommeEnLigneText->GetValue().ToStdString())) {
+        mSommeEnLigne = *somme;
         UpdateSummary();
     }
 }
@@ -514,13 +1126,9 @@ void MainFrame::OnTransactionDoubleClick(wxListEvent& event) {
     }
 
     int transactionId = mTransactionList->GetItemData(selectedItem);
-    auto transactions = mDatabase->GetAllTransactions();
-
-    for (auto& trans : transactions) {
-        if (trans.GetId() == transactionId) {
-            ShowTransactionDialog(&trans);
-            break;
-        }
+    Transaction trans = mDatabase->Call(&Database::GetTransaction, transactionId);
+    if (trans.GetId() == transactionId) {
+        ShowTransactionDialog(&trans);
     }
 }
 
@@ -536,19 +1144,11 @@ void MainFrame::OnTransactionRightClick(wxListEvent& event) {
     int transactionId = mTransactionList->GetItemData(selectedItem);
 
     // Récupérer la transaction pour vérifier son état
-    auto transactions = mDatabase->GetAllTransactions();
-    Transaction* currentTransaction = nullptr;
-
-    for (auto& trans : transactions) {
-        if (trans.GetId() == transactionId) {
-            currentTransaction = &trans;
-            break;
-        }
-    }
-
-    if (currentTransaction == nullptr) {
+    Transaction transaction = mDatabase->Call(&Database::GetTransaction, transactionId);
+    if (transaction.GetId() != transactionId) {
         return;
     }
+    Transaction* currentTransaction = &transaction;
 
     // Créer le menu contextuel
     wxMenu contextMenu;
@@ -657,38 +1257,80 @@ void MainFrame::OnImportCSV(wxCommandEvent& event) {
         return;
     }
 
-    auto mapping = mappingDialog.GetMapping();
+    ImportTransactionsAsync(std::move(csvData), mappingDialog.GetMapping());
+}
+
+DetachedTask MainFrame::ImportTransactionsAsync(std::vector<std::vector<std::string>> csvData,
+                                                CSVImportDialog::FieldMapping mapping) {
+    const size_t rowCount = csvData.size();
+
+    // L'importation tourne sur le thread de la base : le dialogue n'est pas
+    // bloquant et la progression lui parvient par CallAfter
+    auto progress = std::make_unique<wxProgressDialog>("Importation en cours",
+                                                       "Importation des transactions...",
+                                                       rowCount,
+                                                       this,
+                                                       wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_CAN_ABORT);
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    BulkInsertOptions options;
+    options.mOnProgress = [this, dialog = progress.get(), cancelled](size_t done, size_t total) {
+        // Traité avant la reprise de la coroutine : le dialogue existe encore
+        CallAfter([dialog, cancelled, done]() {
+            if (!dialog->Update(static_cast<int>(done))) {
+                cancelled->store(true);
+            }
+        });
+        return !cancelled->load();
+    };
 
-    // Importer les données
-    wxProgressDialog progress("Importation en cours",
-                             "Importation des transactions...",
-                             csvData.size(),
-                             this,
-                             wxPD_APP_MODAL | wxPD_AUTO_HIDE);
+    auto importJob = [csvData = std::move(csvData), mapping, options](Database& db) {
+        return db.ImportTransactionsFromCSV(
+            csvData,
+            mapping.dateColumn,
+            mapping.libelleColumn,
+            mapping.sommeColumn,
+            mapping.typeColumn,
+            mapping.defaultType,
+            mapping.pointeeByDefault,
+            options
+        );
+    };
+    const uint64_t generation = mDatabaseGeneration;
+    ImportResult result = co_await mDatabase->Async(std::move(importJob));
 
-    bool success = mDatabase->ImportTransactionsFromCSV(
-        csvData,
-        mapping.dateColumn,
-        mapping.libelleColumn,
-        mapping.sommeColumn,
-        mapping.typeColumn,
-        mapping.defaultType,
-        mapping.pointeeByDefault
-    );
+    progress->Update(rowCount);
+    progress.reset();
 
-    progress.Update(csvData.size());
+    // Les types créés par l'importation rejoignent ceux de l'interface ici,
+    // pendant qu'elle attend, et non sur le thread de la base
+    if (generation == mDatabaseGeneration) {
+        mDatabase->Call(&Database::ReloadTypes);
+    }
 
-    if (success) {
-        wxMessageBox(wxString::Format("Importation réussie : %zu transactions importées",
-                                     csvData.size()),
+    if (result.IsSuccess()) {
+        wxMessageBox(wxString::Format("Importation réussie : %d transactions importées",
+                                     result.mSuccessCount),
                     "Succès", wxOK | wxICON_INFORMATION);
-        LoadTransactions();
-        UpdateSummary();
+    } else if (result.mRolledBack) {
+        wxMessageBox(wxString::Format("L'importation a été annulée.\n"
+                                     "Aucune des %zu lignes n'a été conservée.",
+                                     rowCount),
+                    "Attention", wxOK | wxICON_WARNING);
     } else {
-        wxMessageBox("L'importation s'est terminée avec des erreurs.\n"
-                    "Certaines transactions n'ont pas pu être importées.",
+        wxString details;
+        for (size_t i = 0; i < result.mErrors.size() && i < 10; ++i) {
+            details += wxString::Format("\n  Ligne %zu : %s", result.mErrors[i].mRow + 2,
+                                        wxString::FromUTF8(result.mErrors[i].mMessage));
+        }
+        wxMessageBox(wxString::Format("L'importation s'est terminée avec des erreurs.\n"
+                                     "%d transaction(s) importée(s), %d ligne(s) ignorée(s).%s",
+                                     result.mSuccessCount, result.mErrorCount, details),
                     "Attention", wxOK | wxICON_WARNING);
-        LoadTransactions();
+    }
+
+    if (generation == mDatabaseGeneration) {
+        RefreshTransactions();
         UpdateSummary();
     }
 }
@@ -768,19 +1410,30 @@ void MainFrame::OnExportCSV(wxCommandEvent& event) {
     }
     
     // Récupérer les options choisies
-    char separator = ';';
-    if (radioComma->GetValue()) separator = ',';
-    else if (radioTab->GetValue()) separator = '\t';
+    CsvFormat format;
+    if (radioComma->GetValue()) format.mSeparator = ',';
+    else if (radioTab->GetValue()) format.mSeparator = '\t';
     
-    wxString dateFormat = "%d/%m/%Y";
-    if (radioDateYMD->GetValue()) dateFormat = "%Y-%m-%d";
-    else if (radioDateMDY->GetValue()) dateFormat = "%m/%d/%Y";
+    if (radioDateYMD->GetValue()) format.mDateFormat = "%Y-%m-%d";
+    else if (radioDateMDY->GetValue()) format.mDateFormat = "%m/%d/%Y";
     
-    bool includeHeader = checkHeader->GetValue();
-    bool useQuotes = checkQuotes->GetValue();
+    format.mUseQuotes = checkQuotes->GetValue();
+    format.mIncludeSign = checkSign->GetValue();
+    format.mDisplay = Settings::GetInstance().GetDisplayFormat();
+    format.mYes = _("Yes");
+    format.mNo = _("No");
     bool onlyVisible = checkOnlyVisible->GetValue();
-    bool includeSign = checkSign->GetValue();
-    bool useUTF8 = radioUTF8->GetValue();
+    
+    // Écrire l'en-tête si demandé
+    if (checkHeader->GetValue()) {
+        const char separator = format.mSeparator;
+        format.mHeader = format.Escape(_("Date")) + separator
+                       + format.Escape(_("Description")) + separator
+                       + format.Escape(_("Amount")) + separator
+                       + format.Escape(_("Type")) + separator
+                       + format.Escape(_("Checked")) + separator
+                       + format.Escape(_("Check Date")) + "\n";
+    }
     
     // Demander où sauvegarder le fichier
     wxFileDialog saveFileDialog(this, _("Export to CSV"), "", 
@@ -794,102 +1447,80 @@ void MainFrame::OnExportCSV(wxCommandEvent& event) {
     
     wxString filePath = saveFileDialog.GetPath();
     
-    try {
-        std::ofstream csvFile(filePath.ToStdString());
+    if (!onlyVisible) {
+        ExportCSVAsync(filePath, std::move(format));
+        return;
+    }
+    
+    // Transactions affichées : déjà en mémoire, écrites directement
+    std::ofstream csvFile(filePath.ToStdString());
+    if (!csvFile.is_open()) {
+        wxMessageBox(_("Unable to create CSV file"), 
+                    _("Error"), wxOK | wxICON_ERROR);
+        return;
+    }
+    
+    csvFile << format.mHeader;
+    const TypeRegistry& types = mDatabase->GetTypeRegistry();
+    for (const auto& trans : mCachedTransactions) {
+        format.WriteRow(csvFile, types, trans.GetDate(), trans.GetLibelle(), trans.GetSomme(),
+                        trans.GetTypeId(), trans.IsPointee(), trans.GetDatePointee());
+    }
+    csvFile.close();
+    if (!csvFile) {
+        wxMessageBox(_("Unable to create CSV file"), 
+                    _("Error"), wxOK | wxICON_ERROR);
+        return;
+    }
+    
+    wxMessageBox(wxString::Format(_("CSV export successful!\n\nFile: %s\nTransactions exported: %zu"),
+                                  filePath, mCachedTransactions.size()),
+                _("Success"), wxOK | wxICON_INFORMATION);
+}
+
+DetachedTask MainFrame::ExportCSVAsync(wxString filePath, CsvFormat format) {
+    // Export complet par date, lu en flux sur un instantané depuis le thread
+    // des rapports ; les types sont copiés comme pour le rapport texte.
+    auto writeCsv = [path = filePath.ToStdString(), format = std::move(format),
+                     typeList = mDatabase->GetTypeRegistry().GetTypes()](ReadSnapshot& snapshot) -> std::optional<size_t> {
+        TypeRegistry types;
+        types.Load(typeList);
+
+        std::ofstream csvFile(path);
         if (!csvFile.is_open()) {
-            wxMessageBox(_("Unable to create CSV file"), 
-                        _("Error"), wxOK | wxICON_ERROR);
-            return;
-        }
-        
-        // Helper pour échapper les champs si nécessaire
-        auto escapeField = [useQuotes, separator](const wxString& field) -> std::string {
-            std::string result = field.ToStdString();
-            if (useQuotes || result.find(separator) != std::string::npos || 
-                result.find('"') != std::string::npos || result.find('\n') != std::string::npos) {
-                // Doubler les guillemets existants
-                size_t pos = 0;
-                while ((pos = result.find('"', pos)) != std::string::npos) {
-                    result.insert(pos, "\"");
-                    pos += 2;
-                }
-                result = "\"" + result + "\"";
-            }
-            return result;
-        };
-        
-        // Écrire l'en-tête si demandé
-        if (includeHeader) {
-            csvFile << escapeField(_("Date")) << separator
-                   << escapeField(_("Description")) << separator
-                   << escapeField(_("Amount")) << separator
-                   << escapeField(_("Type")) << separator
-                   << escapeField(_("Checked")) << separator
-                   << escapeField(_("Check Date")) << "\n";
-        }
-        
-        // Choisir les transactions à exporter
-        std::vector<Transaction> transactionsToExport;
-        if (onlyVisible) {
-            transactionsToExport = mCachedTransactions;
-        } else {
-            transactionsToExport = mDatabase->GetAllTransactions();
-            // Trier par date
-            std::sort(transactionsToExport.begin(), transactionsToExport.end(),
-                [](const Transaction& a, const Transaction& b) {
-                    return a.GetDate() < b.GetDate();
-                });
-        }
-        
-        Settings& settings = Settings::GetInstance();
-        
-        // Écrire les transactions
-        for (const auto& trans : transactionsToExport) {
-            // Date
-            wxString dateStr = trans.GetDate().Format(dateFormat);
-            csvFile << escapeField(dateStr) << separator;
-            
-            // Libellé
-            csvFile << escapeField(trans.GetLibelle()) << separator;
-            
-            // Montant
-            wxString montantStr;
-            bool isDepense = mDatabase->IsTypeDepense(trans.GetType());
-            if (includeSign) {
-                montantStr = (isDepense ? "-" : "+") + settings.FormatMoney(trans.GetSomme());
-            } else {
-                montantStr = settings.FormatMoney(trans.GetSomme());
-                if (isDepense) {
-                    montantStr = "-" + montantStr;
-                }
-            }
-            csvFile << escapeField(montantStr) << separator;
-            
-            // Type
-            csvFile << escapeField(trans.GetType()) << separator;
-            
-            // Pointée
-            csvFile << escapeField(trans.IsPointee() ? _("Yes") : _("No")) << separator;
-            
-            // Date pointée
-            if (trans.IsPointee() && trans.GetDatePointee().IsValid()) {
-                wxString datePointeeStr = trans.GetDatePointee().Format(dateFormat);
-                csvFile << escapeField(datePointeeStr);
-            }
-            
-            csvFile << "\n";
+            return std::nullopt;
         }
-        
+
+        csvFile << format.mHeader;
+        TransactionQuery query;
+        query.mSortKey = TransactionSortKey::DATE;
+        size_t count = snapshot.ForEachTransaction(query, [&](const TransactionRow& row) {
+            format.WriteRow(csvFile, types, DayNumber::ToDateTime(row.mDate), row.mLibelle, row.mSomme,
+                            row.mTypeId, row.mPointee,
+                            row.mDatePointee ? DayNumber::ToDateTime(*row.mDatePointee) : wxDateTime());
+            return true;
+        });
+
         csvFile.close();
-        
-        wxMessageBox(wxString::Format(_("CSV export successful!\n\nFile: %s\nTransactions exported: %zu"),
-                                      filePath, transactionsToExport.size()),
-                    _("Success"), wxOK | wxICON_INFORMATION);
-        
-    } catch (const std::exception& e) {
-        wxMessageBox(wxString::Format(_("Export error: %s"), e.what()),
+        if (!csvFile) {
+            return std::nullopt;
+        }
+        return count;
+    };
+    std::optional<size_t> exportedCount = co_await mDatabase->AsyncReport(std::move(writeCsv));
+
+    if (!exportedCount) {
+        wxMessageBox(_("Unable to create CSV file"), 
                     _("Error"), wxOK | wxICON_ERROR);
+        if (wxFileExists(filePath)) {
+            wxRemoveFile(filePath);
+        }
+        co_return;
     }
+
+    wxMessageBox(wxString::Format(_("CSV export successful!\n\nFile: %s\nTransactions exported: %zu"),
+                                  filePath, *exportedCount),
+                _("Success"), wxOK | wxICON_INFORMATION);
 }
 
 void MainFrame::OnColumnClick(wxListEvent& event) {
@@ -909,41 +1540,17 @@ void MainFrame::OnColumnClick(wxListEvent& event) {
     UpdateColumnHeaders();
 
     mTransactionList->DeleteAllItems();
-    Settings& settings = Settings::GetInstance();
 
     for (size_t i = 0; i < mCachedTransactions.size(); ++i) {
-        const auto& trans = mCachedTransactions[i];
-        long index = mTransactionList->InsertItem(i, settings.FormatDate(trans.GetDate()));
-        mTransactionList->SetItem(index, 1, trans.GetLibelle());
-
-        // Afficher avec signe + ou - selon le type
-        bool isDepense = mDatabase->IsTypeDepense(trans.GetType());
-        wxString sommeStr;
-        if (isDepense) {
-            sommeStr = "-" + settings.FormatMoney(trans.GetSomme());
-            mTransactionList->SetItemTextColour(index, wxColour(220, 100, 100));
-        } else {
-            sommeStr = "+" + settings.FormatMoney(trans.GetSomme());
-            mTransactionList->SetItemTextColour(index, wxColour(100, 180, 120));
-        }
-
-        mTransactionList->SetItem(index, 2, sommeStr);
-        mTransactionList->SetItem(index, 3, trans.IsPointee() ? "Oui" : "Non");
-
-        if (trans.IsPointee() && trans.GetDatePointee().IsValid()) {
-            mTransactionList->SetItem(index, 4, settings.FormatDate(trans.GetDatePointee()));
-        } else {
-            mTransactionList->SetItem(index, 4, "");
-        }
-
-        mTransactionList->SetItem(index, 5, trans.GetType());
-        mTransactionList->SetItemData(index, trans.GetId());
+        long index = mTransactionList->InsertItem(i, wxEmptyString);
+        FillTransactionRow(index, mCachedTransactions[i]);
     }
 }
 
 void MainFrame::SortTransactions(int column) {
+    const TypeRegistry& types = mDatabase->GetTypeRegistry();
     std::stable_sort(mCachedTransactions.begin(), mCachedTransactions.end(),
-        [this, column](const Transaction& a, const Transaction& b) -> bool {
+        [this, column, &types](const Transaction& a, const Transaction& b) -> bool {
             bool result = false;
 
             switch (column) {
@@ -988,9 +1595,18 @@ void MainFrame::SortTransactions(int column) {
                     break;
 
                 case 5: // Type
-                    result = a.GetType() < b.GetType();
+                    result = types.GetName(a.GetTypeId()) < types.GetName(b.GetTypeId());
                     break;
 
+                case 6: { // Solde
+                    auto balanceA = mRunningBalances.find(a.GetId());
+                    auto balanceB = mRunningBalances.find(b.GetId());
+                    Money soldeA = balanceA != mRunningBalances.end() ? balanceA->second : Money();
+                    Money soldeB = balanceB != mRunningBalances.end() ? balanceB->second : Money();
+                    result = soldeA < soldeB;
+                    break;
+                }
+
                 default:
                     result = a.GetId() < b.GetId();
                     break;
@@ -1009,11 +1625,12 @@ void MainFrame::UpdateColumnHeaders() {
         _("Amount"),
         _("Checked"),
         _("Check Date"),
-        _("Type")
+        _("Type"),
+        _("Balance")
     };
 
     // Mettre à jour chaque colonne
-    for (int i = 0; i < 6; ++i) {
+    for (int i = 0; i < 7; ++i) {
         wxListItem col;
         col.SetMask(wxLIST_MASK_TEXT);
 
@@ -1031,7 +1648,7 @@ void MainFrame::UpdateColumnHeaders() {
 
 void MainFrame::OnSearchChanged(wxCommandEvent& event) {
     mSearchText = mSearchBox->GetValue();
-    LoadTransactions();
+    UpdateSearchMatches();
 }
 
 void MainFrame::OnRapprochement(wxCommandEvent& event) {
@@ -1052,21 +1669,21 @@ void MainFrame::EnterRapprochementMode() {
     wxTextEntryDialog dialog(this,
                             _("Enter the balance shown on your bank statement:"),
                             _("Bank Reconciliation"),
-                            wxString::Format("%.2f", mSommeEnLigne));
+                            mSommeEnLigne.ToString());
 
     if (dialog.ShowModal() != wxID_OK) {
         return;
     }
 
-    double solde;
-    if (!dialog.GetValue().ToDouble(&solde)) {
+    auto solde = Money::Parse(dialog.GetValue().ToStdString());
+    if (!solde) {
         wxMessageBox(_("Invalid value"), _("Error"), wxOK | wxICON_ERROR);
         return;
     }
 
     // Mettre à jour le solde en ligne
-    mSommeEnLigne = solde;
-    mSommeEnLigneText->SetValue(wxString::Format("%.2f", mSommeEnLigne));
+    mSommeEnLigne = *solde;
+    mSommeEnLigneText->SetValue(mSommeEnLigne.ToString());
 
     // Activer le mode rapprochement
     mRapprochementMode = true;
@@ -1091,6 +1708,10 @@ void MainFrame::EnterRapprochementMode() {
 void MainFrame::ExitRapprochementMode() {
     mRapprochementMode = false;
 
+    // Écrire les pointages en attente avant de quitter le mode
+    mFlushTimer.Stop();
+    FlushPendingPointees();
+
     // Réactiver l'option "Masquer pointées"
     GetMenuBar()->Enable(ID_HIDE_POINTEES, true);
 
@@ -1114,26 +1735,37 @@ void MainFrame::OnRapprochementItemChecked(wxListEvent& event) {
     int transactionId = mTransactionList->GetItemData(index);
     bool isChecked = mTransactionList->IsItemChecked(index);
 
-    // Trouver la transaction et mettre à jour son état
-    auto transactions = mDatabase->GetAllTransactions();
-    for (auto& trans : transactions) {
-        if (trans.GetId() == transactionId) {
-            trans.SetPointee(isChecked);
-
-            // Si on pointe la transaction, enregistrer la date actuelle
-            if (isChecked) {
-                trans.SetDatePointee(wxDateTime::Now());
-            } else {
-                trans.SetDatePointee(wxDateTime());
-            }
+    // Pointage différé : les cases cochées à la suite sont écrites
+    // ensemble, en une seule transaction, après un court délai
+    if (auto delta = mDatabase->Call(&Database::QueuePointee, transactionId,
+                                      isChecked, wxDateTime::Today())) {
+        ApplyTransactionDelta(*delta);
 
-            mDatabase->UpdateTransaction(trans);
-            UpdateSummary();
-            break;
+        const auto now = std::chrono::steady_clock::now();
+        if (!mFlushDeadline) {
+            mFlushDeadline = now + kPointeeMaxDelay;
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(*mFlushDeadline - now);
+        if (remaining.count() <= 0) {
+            mFlushTimer.Stop();
+            FlushPendingPointees();
+        } else {
+            mFlushTimer.StartOnce(static_cast<int>(std::min<long long>(kPointeeFlushDelayMs, remaining.count())));
         }
     }
 }
 
+void MainFrame::OnFlushTimer(wxTimerEvent& event) {
+    FlushPendingPointees();
+}
+
+void MainFrame::FlushPendingPointees() {
+    mFlushDeadline.reset();
+    if (!mDatabase->Call(&Database::FlushPendingWrites)) {
+        SetStatusText(_("Error saving checked transactions"));
+    }
+}
+
 void MainFrame::OnToggleHidePointees(wxCommandEvent& event) {
     mHidePointees = event.IsChecked();
     
@@ -1165,8 +1797,11 @@ void MainFrame::FilterTransactions() {
             mCachedTransactions = mAllTransactions;
         }
     } else {
-        // Filtrer par libellé ou montant
+        // Filtrer par libellé (résultat de la recherche en base) ou montant
         wxString searchLower = mSearchText.Lower();
+        // Un montant formaté ne contient que des chiffres, signes et séparateurs
+        const bool searchAmounts = searchLower.find_first_not_of("0123456789+-., ") == wxString::npos;
+        Settings& settings = Settings::GetInstance();
 
         for (const auto& trans : mAllTransactions) {
             // En mode rapprochement OU si l'option "masquer pointées" est active,
@@ -1176,14 +1811,16 @@ void MainFrame::FilterTransactions() {
             }
 
             // Recherche dans le libellé
-            wxString libelle = wxString(trans.GetLibelle()).Lower();
-            if (libelle.Contains(searchLower)) {
+            if (MatchesSearchLibelle(trans)) {
                 mCachedTransactions.push_back(trans);
                 continue;
             }
 
+            if (!searchAmounts) {
+                continue;
+            }
+
             // Recherche dans le montant
-            Settings& settings = Settings::GetInstance();
             wxString sommeStr = settings.FormatMoney(trans.GetSomme());
             if (sommeStr.Contains(searchLower)) {
                 mCachedTransactions.push_back(trans);
@@ -1191,13 +1828,44 @@ void MainFrame::FilterTransactions() {
             }
 
             // Recherche avec le signe + ou -
-            bool isDepense = mDatabase->IsTypeDepense(trans.GetType());
+            bool isDepense = mDatabase->IsTypeDepense(trans.GetTypeId());
             wxString sommeWithSign = (isDepense ? "-" : "+") + sommeStr;
             if (sommeWithSign.Contains(searchLower)) {
                 mCachedTransactions.push_back(trans);
             }
         }
+
+        // Sans colonne de tri, les libellés trouvés dans l'index viennent par
+        // pertinence, puis les autres correspondances dans l'ordre de la liste
+        if (mSortColumn < 0 && mSearchUsesIndex) {
+            auto rankOf = [this](const Transaction& trans) {
+                auto it = mSearchMatches.find(trans.GetId());
+                return it != mSearchMatches.end() ? it->second : mSearchMatches.size();
+            };
+            std::stable_sort(mCachedTransactions.begin(), mCachedTransactions.end(),
+                             [&rankOf](const Transaction& a, const Transaction& b) {
+                                 return rankOf(a) < rankOf(b);
+                             });
+        }
+    }
+}
+
+bool MainFrame::MatchesSearchLibelle(const Transaction& trans) const {
+    // Sans aucun mot (par exemple « * »), aucun libellé ne correspond
+    if (!mSearchUsesIndex && mSearchShortWords.empty()) {
+        return false;
+    }
+    if (mSearchUsesIndex && !mSearchMatches.count(trans.GetId())) {
+        return false;
     }
+    if (mSearchShortWords.empty()) {
+        return true;
+    }
+
+    const std::string& libelle = trans.GetLibelle();
+    wxString libelleLower = wxString::FromUTF8(libelle.data(), libelle.size()).Lower();
+    return std::all_of(mSearchShortWords.begin(), mSearchShortWords.end(),
+                       [&libelleLower](const wxString& word) { return libelleLower.Contains(word); });
 }
 
 void MainFrame::OnUpdateToggleHidePointees(wxUpdateUIEvent& event) {
@@ -1205,61 +1873,152 @@ void MainFrame::OnUpdateToggleHidePointees(wxUpdateUIEvent& event) {
 }
 
 void MainFrame::OnBackup(wxCommandEvent& event) {
-    // Demander à l'utilisateur où sauvegarder le fichier
+    // Demander à l'utilisateur où sauvegarder la base
     wxFileDialog saveFileDialog(this, _("Backup Account"), "", 
-                                "sauvegarde_compte.zip",
-                                _("ZIP files (*.zip)|*.zip"),
+                                "sauvegarde_compte.db",
+                                _("Database files (*.db)|*.db|ZIP files (*.zip)|*.zip"),
                                 wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
 
     if (saveFileDialog.ShowModal() == wxID_CANCEL) {
         return;
     }
 
-    wxString zipPath = saveFileDialog.GetPath();
-    wxString txtPath = zipPath;
-    txtPath.Replace(".zip", ".txt");
+    wxString path = saveFileDialog.GetPath();
+    if (saveFileDialog.GetFilterIndex() == 1 && !path.Lower().EndsWith(".zip")) {
+        path += ".zip";
+    }
+    BackupAsync(path);
+}
+
+DetachedTask MainFrame::BackupAsync(wxString path) {
+    // Une sauvegarde .zip passe par une copie temporaire de la base
+    const bool zipped = path.Lower().EndsWith(".zip");
+    wxString dbPath = zipped ? wxFileName::CreateTempFileName("mescomptes") : path;
+    if (dbPath.empty()) {
+        wxMessageBox(_("Unable to create backup file"), 
+                    _("Error"), wxOK | wxICON_ERROR);
+        co_return;
+    }
 
-    Settings& settings = Settings::GetInstance();
+    // La copie tourne sur le thread des rapports, sur un instantané : la
+    // fenêtre reste utilisable et la progression arrive par CallAfter
+    auto progress = std::make_unique<wxProgressDialog>(_("Backup Account"),
+                                                       _("Copying the database..."),
+                                                       100,
+                                                       this,
+                                                       wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_CAN_ABORT);
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    auto onProgress = [this, dialog = progress.get(), cancelled](int remaining, int pageCount) {
+        int percent = pageCount > 0 ? (pageCount - remaining) * 100 / pageCount : 0;
+        // Traité avant la reprise de la coroutine : le dialogue existe encore
+        CallAfter([dialog, cancelled, percent]() {
+            if (percent < 100 && !dialog->Update(percent)) {
+                cancelled->store(true);
+            }
+        });
+        return !cancelled->load();
+    };
+
+    auto backup = [dbPath = dbPath.ToStdString(), zipPath = path, zipped,
+                   entryName = wxFileName(path).GetName() + ".db", onProgress](ReadSnapshot& snapshot) -> std::optional<size_t> {
+        size_t count = static_cast<size_t>(snapshot.GetTransactionCount());
+        if (!snapshot.BackupTo(dbPath, ReadSnapshot::kBackupPagesPerStep, onProgress)) {
+            return std::nullopt;
+        }
+        if (!zipped) {
+            return count;
+        }
+
+        // Compresser la copie de la base dans le ZIP
+        bool ok = false;
+        {
+            wxFileInputStream in(dbPath);
+            wxFileOutputStream out(zipPath);
+            if (in.IsOk() && out.IsOk()) {
+                wxZipOutputStream zip(out);
+                ok = zip.IsOk() && zip.PutNextEntry(entryName);
+                if (ok) {
+                    zip.Write(in);
+                    ok = zip.CloseEntry() && zip.Close() && out.Close();
+                }
+            }
+        }
+        wxRemoveFile(dbPath);
+        if (!ok) {
+            wxRemoveFile(zipPath);
+            return std::nullopt;
+        }
+        return count;
+    };
+    std::optional<size_t> transactionCount = co_await mDatabase->AsyncReport(std::move(backup));
+
+    progress.reset();
+
+    if (cancelled->load()) {
+        co_return;
+    }
+    if (!transactionCount) {
+        wxMessageBox(_("Unable to create backup file"), 
+                    _("Error"), wxOK | wxICON_ERROR);
+        co_return;
+    }
+
+    wxMessageBox(wxString::Format(_("Backup created successfully!\n\nFile: %s\nTransactions: %zu"),
+                                  path, *transactionCount),
+                _("Backup successful"), wxOK | wxICON_INFORMATION);
+}
+
+void MainFrame::OnExportReport(wxCommandEvent& event) {
+    wxFileDialog saveFileDialog(this, _("Export Report"), "", 
+                                "rapport_compte.txt",
+                                _("Text files (*.txt)|*.txt"),
+                                wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+    if (saveFileDialog.ShowModal() == wxID_CANCEL) {
+        return;
+    }
 
-    try {
-        // Créer le fichier texte de sauvegarde
-        std::ofstream textFile(txtPath.ToStdString());
+    ExportReportAsync(saveFileDialog.GetPath());
+}
+
+DetachedTask MainFrame::ExportReportAsync(wxString txtPath) {
+    // Le fichier texte est écrit sur le thread des rapports, en lisant les
+    // transactions en flux sur un instantané : la fenêtre reste utilisable et
+    // les modifications faites pendant l'écriture n'y apparaissent pas.
+    // Les types et les réglages d'affichage sont copiés, l'interface pouvant
+    // les modifier entre-temps.
+    auto writeReport = [path = txtPath.ToStdString(),
+                        typeList = mDatabase->GetTypeRegistry().GetTypes(),
+                        format = Settings::GetInstance().GetDisplayFormat()](ReadSnapshot& snapshot) -> std::optional<size_t> {
+        TypeRegistry types;
+        types.Load(typeList);
+
+        std::ofstream textFile(path);
         if (!textFile.is_open()) {
-            wxMessageBox(_("Unable to create backup file"), 
-                        _("Error"), wxOK | wxICON_ERROR);
-            return;
+            return std::nullopt;
         }
 
         // Écrire l'en-tête
         textFile << "=================================================\n";
-        textFile << "        SAUVEGARDE DU COMPTE - MesComptes\n";
+        textFile << "          RAPPORT DU COMPTE - MesComptes\n";
         textFile << "=================================================\n";
-        textFile << "Date de sauvegarde: " << wxDateTime::Now().Format("%d/%m/%Y %H:%M:%S").ToStdString() << "\n";
+        textFile << "Date du rapport: " << wxDateTime::Now().Format("%d/%m/%Y %H:%M:%S").ToStdString() << "\n";
         textFile << "Version: " << MESCOMPTES::VERSION_STRING << "\n";
         textFile << "=================================================\n\n";
 
-        // Récupérer toutes les transactions
-        auto allTransactions = mDatabase->GetAllTransactions();
-
-        // Trier par date
-        std::sort(allTransactions.begin(), allTransactions.end(),
-            [](const Transaction& a, const Transaction& b) {
-                return a.GetDate() < b.GetDate();
-            });
-
         // Écrire les statistiques
         textFile << "STATISTIQUES\n";
         textFile << "------------\n";
-        textFile << "Nombre total de transactions: " << allTransactions.size() << "\n";
-        textFile << "Restant: " << settings.FormatMoney(mDatabase->GetTotalRestant()).ToStdString() << " €\n";
-        textFile << "Somme pointée: " << settings.FormatMoney(mDatabase->GetTotalPointee()).ToStdString() << " €\n";
+        textFile << "Nombre total de transactions: " << snapshot.GetTransactionCount() << "\n";
+        textFile << "Restant: " << format.FormatMoney(snapshot.GetTotalRestant()).ToStdString() << " €\n";
+        textFile << "Somme pointée: " << format.FormatMoney(snapshot.GetTotalPointee()).ToStdString() << " €\n";
         textFile << "\n\n";
 
         // Écrire les types de transactions
         textFile << "TYPES DE TRANSACTIONS\n";
         textFile << "---------------------\n";
-        auto types = mDatabase->GetAllTypes();
-        for (const auto& type : types) {
+        for (const auto& type : types.GetTypes()) {
             textFile << "- " << type.mNom << " (" 
                     << (type.mIsDepense ? "Dépense" : "Recette") << ")\n";
         }
@@ -1269,78 +2028,51 @@ void MainFrame::OnBackup(wxCommandEvent& event) {
         textFile << "LISTE DES TRANSACTIONS\n";
         textFile << "======================\n\n";
 
-        for (const auto& trans : allTransactions) {
-            textFile << "Transaction #" << trans.GetId() << "\n";
-            textFile << "  Date         : " << settings.FormatDate(trans.GetDate()).ToStdString() << "\n";
-            textFile << "  Libellé      : " << trans.GetLibelle() << "\n";
+        // Transactions lues en flux, triées par date
+        TransactionQuery query;
+        query.mSortKey = TransactionSortKey::DATE;
+        size_t count = snapshot.ForEachTransaction(query, [&](const TransactionRow& row) {
+            textFile << "Transaction #" << row.mId << "\n";
+            textFile << "  Date         : " << format.FormatDate(DayNumber::ToDateTime(row.mDate)).ToStdString() << "\n";
+            textFile << "  Libellé      : " << row.mLibelle << "\n";
             
-            bool isDepense = mDatabase->IsTypeDepense(trans.GetType());
+            bool isDepense = types.IsDepense(row.mTypeId);
             textFile << "  Somme        : " << (isDepense ? "-" : "+") 
-                    << settings.FormatMoney(trans.GetSomme()).ToStdString() << " €\n";
+                    << format.FormatMoney(row.mSomme).ToStdString() << " €\n";
             
-            textFile << "  Type         : " << trans.GetType() << "\n";
-            textFile << "  Pointée      : " << (trans.IsPointee() ? "Oui" : "Non") << "\n";
+            textFile << "  Type         : " << types.GetName(row.mTypeId) << "\n";
+            textFile << "  Pointée      : " << (row.mPointee ? "Oui" : "Non") << "\n";
             
-            if (trans.IsPointee() && trans.GetDatePointee().IsValid()) {
-                textFile << "  Date pointée : " << settings.FormatDate(trans.GetDatePointee()).ToStdString() << "\n";
+            if (row.mPointee && row.mDatePointee) {
+                textFile << "  Date pointée : " << format.FormatDate(DayNumber::ToDateTime(*row.mDatePointee)).ToStdString() << "\n";
             }
             
             textFile << "\n";
-        }
+            return true;
+        });
 
         textFile << "=================================================\n";
-        textFile << "           FIN DE LA SAUVEGARDE\n";
+        textFile << "             FIN DU RAPPORT\n";
         textFile << "=================================================\n";
 
         textFile.close();
-
-        // Compresser le fichier texte dans un ZIP
-        wxFileOutputStream out(zipPath);
-        if (!out.IsOk()) {
-            wxMessageBox(_("Unable to create backup file"), 
-                        _("Error"), wxOK | wxICON_ERROR);
-            wxRemoveFile(txtPath);
-            return;
-        }
-
-        wxZipOutputStream zip(out);
-        if (!zip.IsOk()) {
-            wxMessageBox(_("Unable to create backup file"), 
-                        _("Error"), wxOK | wxICON_ERROR);
-            wxRemoveFile(txtPath);
-            return;
-        }
-
-        // Ajouter le fichier texte au ZIP
-        wxFileInputStream in(txtPath);
-        if (!in.IsOk()) {
-            wxMessageBox(_("Unable to create backup file"), 
-                        _("Error"), wxOK | wxICON_ERROR);
-            wxRemoveFile(txtPath);
-            return;
+        if (!textFile) {
+            return std::nullopt;
         }
+        return count;
+    };
+    std::optional<size_t> transactionCount = co_await mDatabase->AsyncReport(std::move(writeReport));
 
-        wxString filename = wxFileName(txtPath).GetFullName();
-        zip.PutNextEntry(filename);
-        zip.Write(in);
-
-        zip.CloseEntry();
-        zip.Close();
-        out.Close();
-
-        // Supprimer le fichier texte temporaire
-        wxRemoveFile(txtPath);
-
-        wxMessageBox(wxString::Format(_("Backup created successfully!\n\nFile: %s\nTransactions: %zu"),
-                                      zipPath, allTransactions.size()),
-                    _("Backup successful"), wxOK | wxICON_INFORMATION);
-
-    } catch (const std::exception& e) {
-        wxMessageBox(wxString::Format(_("Export error: %s"), e.what()),
+    if (!transactionCount) {
+        wxMessageBox(_("Unable to create report file"), 
                     _("Error"), wxOK | wxICON_ERROR);
-        // Nettoyer les fichiers temporaires
         if (wxFileExists(txtPath)) {
             wxRemoveFile(txtPath);
         }
+        co_return;
     }
+
+    wxMessageBox(wxString::Format(_("Report exported successfully!\n\nFile: %s\nTransactions: %zu"),
+                                  txtPath, *transactionCount),
+                _("Export successful"), wxOK | wxICON_INFORMATION);
 }
\ No newline at end of file
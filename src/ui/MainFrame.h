@@ -8,8 +8,17 @@
 #include <wx/wx.h>
 #include <wx/listctrl.h>
 #include <wx/srchctrl.h>
-#include <core/Database.h>
+#include <wx/timer.h>
+#include <core/AsyncDatabase.h>
+#include <core/AccountRegistry.h>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include "CSVImportDialog.h"
+
+class Settings;
 
 class MainFrame : public wxFrame {
 public:
@@ -19,19 +28,37 @@ public:
 private:
     void CreateMenuBar();
     void CreateControls();
-    void LoadTransactions();
-    void UpdateSummary();
+    DetachedTask LoadTransactions();
+    // Relit seulement les transactions modifiées depuis le dernier affichage
+    DetachedTask RefreshTransactions();
+    void RenderTransactions();
+    // Recherche les libellés dans l'index de la base puis réaffiche la liste
+    DetachedTask UpdateSearchMatches();
+    void FillTransactionRow(long index, const Transaction& trans);
+    void ApplyTransactionDelta(const TransactionDelta& delta);
+    DetachedTask UpdateSummary();
+    // Relit les soldes progressifs et met à jour leur colonne
+    DetachedTask LoadRunningBalances();
+    wxString FormatRunningBalance(const Settings& settings, int id) const;
+    // Remplace la base ouverte par celle de path
+    bool OpenDatabase(const std::string& path);
+    void CheckPendingRecurring();
+    // Comptes : menu de sélection et changement de la base affichée
+    void UpdateAccountsMenu();
+    void SwitchAccount(const Account& account);
 
     // Event handlers
     void OnQuit(wxCommandEvent& event);
     void OnPreferences(wxCommandEvent& event);
     void OnInfo(wxCommandEvent& event);
+    void OnVerifyBalances(wxCommandEvent& event);
     void OnAbout(wxCommandEvent& event);
     void OnAddTransaction(wxCommandEvent& event);
     void OnDeleteTransaction(wxCommandEvent& event);
     void OnManageRecurring(wxCommandEvent& event);
     void OnImportCSV(wxCommandEvent& event);
     void OnExportCSV(wxCommandEvent& event);
+    void OnExportReport(wxCommandEvent& event);
     void OnTogglePointee(wxCommandEvent& event);
     void OnSommeEnLigneChanged(wxCommandEvent& event);
     void OnTransactionDoubleClick(wxListEvent& event);
@@ -43,14 +70,28 @@ private:
     void OnToggleHidePointees(wxCommandEvent& event);
     void OnUpdateToggleHidePointees(wxUpdateUIEvent& event);
     void OnBackup(wxCommandEvent& event);
+    void OnFlushTimer(wxTimerEvent& event);
+    void OnConsolidatedSummary(wxCommandEvent& event);
+    void ShowConsolidatedSummary(const ConsolidatedSummary& summary);
+    void OnAddAccount(wxCommandEvent& event);
+    void OnRemoveAccount(wxCommandEvent& event);
+    void OnSelectAccount(wxCommandEvent& event);
 
     // Helper methods
     void ShowTransactionDialog(Transaction* existingTransaction = nullptr);
     void SortTransactions(int column);
     void UpdateColumnHeaders();
     void FilterTransactions();
+    bool MatchesSearchLibelle(const Transaction& trans) const;
     void EnterRapprochementMode();
     void ExitRapprochementMode();
+    void FlushPendingPointees();
+    DetachedTask ImportTransactionsAsync(std::vector<std::vector<std::string>> csvData,
+                                         CSVImportDialog::FieldMapping mapping);
+    DetachedTask BackupAsync(wxString path);
+    DetachedTask ExportReportAsync(wxString txtPath);
+    struct CsvFormat;
+    DetachedTask ExportCSVAsync(wxString filePath, CsvFormat format);
 
     // Widgets
     wxListCtrl* mTransactionList;
@@ -61,18 +102,33 @@ private:
     wxSearchCtrl* mSearchBox;
 
     // Database
-    std::unique_ptr<Database> mDatabase;
-    double mSommeEnLigne;
+    std::unique_ptr<AsyncDatabase> mDatabase;
+    AccountRegistry mAccounts;
+    wxMenu* mAccountsMenu;
+    std::future<void> mSummaryTask;  // Lecture des comptes de la synthèse consolidée
+    Money mSommeEnLigne;
 
     // Sorting
     int mSortColumn;
     bool mSortAscending;
     std::vector<Transaction> mCachedTransactions;
     std::vector<Transaction> mAllTransactions;
+    std::unordered_map<int, Money> mRunningBalances;  // Solde après chaque transaction, par id
+    int mPendingLoads;  // Chargements envoyés au thread de la base et pas encore affichés
+    uint64_t mDataVersion;  // Version de la base reflétée par mAllTransactions
+    uint64_t mDatabaseGeneration;  // Incrémentée à chaque ouverture de base (changement de compte)
     wxString mSearchText;
+    std::unordered_map<int, size_t> mSearchMatches;  // Rang dans l'index des libellés trouvés, par id
+    std::vector<wxString> mSearchShortWords;  // Mots trop courts pour l'index, en minuscules
+    bool mSearchUsesIndex;  // mSearchText contient au moins un mot cherché dans l'index
+    int mPendingSearches;
 
     // Rapprochement mode
     bool mRapprochementMode;
+    // Écriture différée des pointages, quelques secondes après le dernier
+    wxTimer mFlushTimer;
+    // Écriture au plus tard à cette échéance, fixée par le premier pointage en attente
+    std::optional<std::chrono::steady_clock::time_point> mFlushDeadline;
 
     // Display options
     bool mHidePointees;
@@ -87,6 +143,7 @@ enum {
     ID_ADD_TRANSACTION,
     ID_IMPORT_CSV,
     ID_EXPORT_CSV,
+    ID_EXPORT_REPORT,
     ID_DELETE_TRANSACTION,
     ID_TOGGLE_POINTEE,
     ID_SOMME_EN_LIGNE,
@@ -95,7 +152,14 @@ enum {
     ID_RAPPROCHEMENT,
     ID_HIDE_POINTEES,
     ID_MANAGE_RECURRING,
-    ID_BACKUP
+    ID_BACKUP,
+    ID_VERIFY_BALANCES,
+    ID_FLUSH_TIMER,
+    ID_CONSOLIDATED_SUMMARY,
+    ID_ADD_ACCOUNT,
+    ID_REMOVE_ACCOUNT,
+    ID_ACCOUNT_FIRST,
+    ID_ACCOUNT_LAST = ID_ACCOUNT_FIRST + 49  // Un élément de menu par compte
 };
 
 #endif // MAINFRAME_H
\ No newline at end of file
@@ -15,7 +15,7 @@ wxBEGIN_EVENT_TABLE(PreferencesDialog, wxDialog)
     EVT_CHOICE(ID_DECIMAL_SEPARATOR, PreferencesDialog::OnDecimalSeparatorChanged)
 wxEND_EVENT_TABLE()
 
-PreferencesDialog::PreferencesDialog(wxWindow* parent, Database* database)
+PreferencesDialog::PreferencesDialog(wxWindow* parent, AsyncDatabase* database)
     : wxDialog(parent, wxID_ANY, _("Preferences"),
                wxDefaultPosition, wxSize(600, 400)),
       mDatabase(database) {
@@ -154,7 +154,7 @@ void PreferencesDialog::CreateDisplayPage(wxNotebook* notebook) {
 void PreferencesDialog::LoadTypes() {
     mTypesList->DeleteAllItems();
 
-    auto types = mDatabase->GetAllTypes();
+    const auto& types = mDatabase->GetTypeRegistry().GetTypes();
 
     for (size_t i = 0; i < types.size(); ++i) {
         long index = mTypesList->InsertItem(i, types[i].mNom);
@@ -202,7 +202,7 @@ void PreferencesDialog::OnAdd(wxCommandEvent& event) {
         }
 
         bool isDepense = (categoryChoice->GetSelection() == 0);
-        if (mDatabase->AddType(name.ToStdString(), isDepense)) {
+        if (mDatabase->Call(&Database::AddType, name.ToStdString(), isDepense)) {
             LoadTypes();
         }
     }
@@ -222,13 +222,13 @@ void PreferencesDialog::OnDelete(wxCommandEvent& event) {
                      _("Confirmation"), wxYES_NO | wxICON_QUESTION) == wxYES) {
 
         // Vérifier si le type est utilisé
-        if (mDatabase->IsTypeUsed(typeName.ToStdString())) {
+        if (mDatabase->Call(&Database::IsTypeUsed, typeName.ToStdString())) {
             wxMessageBox(_("This type is used by existing transactions and cannot be deleted."),
                         _("Warning"), wxOK | wxICON_WARNING);
             return;
         }
 
-        if (mDatabase->DeleteType(typeName.ToStdString())) {
+        if (mDatabase->Call(&Database::DeleteType, typeName.ToStdString())) {
             LoadTypes();
         } else {
             wxMessageBox(_("Error deleting transaction"),
@@ -258,7 +258,6 @@ void PreferencesDialog::OnEdit(wxCommandEvent& event) {
     sizer->Add(label, 0, wxALL, 5);
 
     wxTextCtrl* nameText = new wxTextCtrl(&dialog, wxID_ANY, oldName);
-    nameText->SetEditable(false);  // Disable renaming since UpdateType doesn't support it
     sizer->Add(nameText, 0, wxALL | wxEXPAND, 5);
 
     wxStaticText* categoryLabel = new wxStaticText(&dialog, wxID_ANY, _("Category:"));
@@ -282,9 +281,16 @@ void PreferencesDialog::OnEdit(wxCommandEvent& event) {
 
     if (dialog.ShowModal() == wxID_OK) {
         bool isDepense = (categoryChoice->GetSelection() == 0);
+        wxString newName = nameText->GetValue().Trim().Trim(false);
 
-        // Only update the category flag, not the name
-        if (mDatabase->UpdateType(oldName.ToStdString(), isDepense)) {
+        // Les transactions ne référencent que l'id du type : le renommage
+        // ne modifie qu'une ligne de la table types
+        bool success = !newName.IsEmpty();
+        if (success && newName != oldName) {
+            success = mDatabase->Call(&Database::RenameType, oldName.ToStdString(), newName.ToStdString());
+        }
+
+        if (success && mDatabase->Call(&Database::UpdateType, newName.ToStdString(), isDepense)) {
             LoadTypes();
         } else {
             wxMessageBox(_("Error updating transaction"),
@@ -307,7 +313,7 @@ void PreferencesDialog::OnDateFormatChanged(wxCommandEvent& event) {
 void PreferencesDialog::OnDecimalSeparatorChanged(wxCommandEvent& event) {
     Settings& settings = Settings::GetInstance();
     settings.SetDecimalSeparator(static_cast<Settings::DecimalSeparator>(mDecimalSeparatorChoice->GetSelection()));
-    mMoneyExample->SetLabel(settings.FormatMoney(1234.56) + " €");
+    mMoneyExample->SetLabel(settings.FormatMoney(Money::FromCents(123456)) + " €");
 }
 
 void PreferencesDialog::OnLanguageChanged(wxCommandEvent& event) {
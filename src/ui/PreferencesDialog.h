@@ -8,11 +8,11 @@
 #include <wx/wx.h>
 #include <wx/listctrl.h>
 #include <wx/notebook.h>
-#include <core/Database.h>
+#include <core/AsyncDatabase.h>
 
 class PreferencesDialog : public wxDialog {
 public:
-    PreferencesDialog(wxWindow* parent, Database* database);
+    PreferencesDialog(wxWindow* parent, AsyncDatabase* database);
 
 private:
     void CreateTypesPage(wxNotebook* notebook);
@@ -35,7 +35,7 @@ private:
     wxChoice* mLanguageChoice;
     wxStaticText* mDateExample;
     wxStaticText* mMoneyExample;
-    Database* mDatabase;
+    AsyncDatabase* mDatabase;
 
     wxDECLARE_EVENT_TABLE();
 };
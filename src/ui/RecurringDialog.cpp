@@ -15,7 +15,7 @@ wxBEGIN_EVENT_TABLE(RecurringDialog, wxDialog)
     EVT_LIST_ITEM_DESELECTED(ID_RECURRING_LIST, RecurringDialog::OnItemDeselected)
 wxEND_EVENT_TABLE()
 
-RecurringDialog::RecurringDialog(wxWindow* parent, Database* db)
+RecurringDialog::RecurringDialog(wxWindow* parent, AsyncDatabase* db)
     : wxDialog(parent, wxID_ANY, "Gestion des transactions récurrentes",
                wxDefaultPosition, wxSize(800, 500)), mDatabase(db) {
     CreateControls();
@@ -62,14 +62,14 @@ void RecurringDialog::CreateControls() {
 
 void RecurringDialog::LoadRecurringTransactions() {
     mRecurringList->DeleteAllItems();
-    auto transactions = mDatabase->GetAllRecurringTransactions();
+    auto transactions = mDatabase->Call(&Database::GetAllRecurringTransactions);
 
     for (size_t i = 0; i < transactions.size(); ++i) {
         const auto& trans = transactions[i];
         long index = mRecurringList->InsertItem(i, trans.GetLibelle());
 
-        mRecurringList->SetItem(index, 1, wxString::Format("%.2f €", trans.GetSomme()));
-        mRecurringList->SetItem(index, 2, trans.GetType());
+        mRecurringList->SetItem(index, 1, wxString(trans.GetSomme().ToString() + " €"));
+        mRecurringList->SetItem(index, 2, mDatabase->GetTypeRegistry().GetName(trans.GetTypeId()));
         mRecurringList->SetItem(index, 3, RecurrenceTypeToString(trans.GetRecurrence()));
         mRecurringList->SetItem(index, 4, trans.GetStartDate().FormatISODate());
         mRecurringList->SetItem(index, 5, trans.GetNextExecutionDate().FormatISODate());
@@ -103,7 +103,7 @@ void RecurringDialog::OnEdit(wxCommandEvent& event) {
     if (selectedItem == -1) return;
 
     int id = mRecurringList->GetItemData(selectedItem);
-    auto transactions = mDatabase->GetAllRecurringTransactions();
+    auto transactions = mDatabase->Call(&Database::GetAllRecurringTransactions);
 
     for (auto& trans : transactions) {
         if (trans.GetId() == id) {
@@ -121,7 +121,7 @@ void RecurringDialog::OnDelete(wxCommandEvent& event) {
 
     if (wxMessageBox("Êtes-vous sûr de vouloir supprimer cette récurrence?",
                      "Confirmation", wxYES_NO | wxICON_QUESTION) == wxYES) {
-        if (mDatabase->DeleteRecurringTransaction(id)) {
+        if (mDatabase->Call(&Database::DeleteRecurringTransaction, id)) {
             LoadRecurringTransactions();
         }
     }
@@ -132,7 +132,7 @@ void RecurringDialog::OnExecuteNow(wxCommandEvent& event) {
     if (selectedItem == -1) return;
 
     int id = mRecurringList->GetItemData(selectedItem);
-    auto transactions = mDatabase->GetAllRecurringTransactions();
+    auto transactions = mDatabase->Call(&Database::GetAllRecurringTransactions);
 
     for (auto& trans : transactions) {
         if (trans.GetId() == id) {
@@ -140,12 +140,12 @@ void RecurringDialog::OnExecuteNow(wxCommandEvent& event) {
             newTrans.SetDate(wxDateTime::Today());
             newTrans.SetLibelle(trans.GetLibelle());
             newTrans.SetSomme(trans.GetSomme());
-            newTrans.SetType(trans.GetType());
+            newTrans.SetTypeId(trans.GetTypeId());
             newTrans.SetPointee(false);
 
-            if (mDatabase->AddTransaction(newTrans)) {
+            if (mDatabase->Call(&Database::AddTransaction, newTrans)) {
                 trans.SetLastExecuted(wxDateTime::Today());
-                mDatabase->UpdateRecurringTransaction(trans);
+                mDatabase->Call(&Database::UpdateRecurringTransaction, trans);
 
                 wxMessageBox("Transaction ajoutée avec succès", "Succès",
                            wxOK | wxICON_INFORMATION);
@@ -187,18 +187,18 @@ void RecurringDialog::ShowRecurringDialog(RecurringTransaction* existing) {
     // Somme
     gridSizer->Add(new wxStaticText(&dialog, wxID_ANY, "Montant:"), 0, wxALIGN_CENTER_VERTICAL);
     wxTextCtrl* sommeText = new wxTextCtrl(&dialog, wxID_ANY);
-    if (isEdit) sommeText->SetValue(wxString::Format("%.2f", existing->GetSomme()));
+    if (isEdit) sommeText->SetValue(existing->GetSomme().ToString());
     gridSizer->Add(sommeText, 1, wxEXPAND);
 
     // Type
     gridSizer->Add(new wxStaticText(&dialog, wxID_ANY, "Type:"), 0, wxALIGN_CENTER_VERTICAL);
     wxChoice* typeChoice = new wxChoice(&dialog, wxID_ANY);
-    auto types = mDatabase->GetAllTypes();
+    const auto& types = mDatabase->GetTypeRegistry().GetTypes();
     int selectedIndex = 0;
     for (size_t i = 0; i < types.size(); ++i) {
         wxString displayName = types[i].mNom + (types[i].mIsDepense ? " (Dépense)" : " (Recette)");
         typeChoice->Append(displayName, new wxStringClientData(types[i].mNom));
-        if (isEdit && types[i].mNom == existing->GetType()) {
+        if (isEdit && types[i].mId == existing->GetTypeId()) {
             selectedIndex = i;
         }
     }
@@ -280,15 +280,14 @@ void RecurringDialog::ShowRecurringDialog(RecurringTransaction* existing) {
 
         trans.SetLibelle(libelleText->GetValue().ToStdString());
 
-        double somme;
-        if (sommeText->GetValue().ToDouble(&somme)) {
-            trans.SetSomme(somme);
+        if (auto somme = Money::Parse(sommeText->GetValue().ToStdString())) {
+            trans.SetSomme(*somme);
         }
 
         wxStringClientData* data = static_cast<wxStringClientData*>(
             typeChoice->GetClientObject(typeChoice->GetSelection())
         );
-        trans.SetType(data->GetData().ToStdString());
+        trans.SetTypeId(mDatabase->GetTypeRegistry().GetId(data->GetData().ToStdString()));
 
         trans.SetRecurrence(static_cast<RecurrenceType>(recurrenceChoice->GetSelection()));
         trans.SetDayOfMonth(dayOfMonthSpin->GetValue());
@@ -304,8 +303,8 @@ void RecurringDialog::ShowRecurringDialog(RecurringTransaction* existing) {
             trans.SetLastExecuted(existing->GetLastExecuted());
         }
 
-        bool success = isEdit ? mDatabase->UpdateRecurringTransaction(trans)
-                             : mDatabase->AddRecurringTransaction(trans);
+        bool success = isEdit ? mDatabase->Call(&Database::UpdateRecurringTransaction, trans)
+                             : mDatabase->Call(&Database::AddRecurringTransaction, trans);
 
         if (success) {
             LoadRecurringTransactions();
@@ -10,12 +10,12 @@
 #include <wx/spinctrl.h>
 #include <wx/datectrl.h>
 #include <wx/dateevt.h>
-#include <core/Database.h>
+#include <core/AsyncDatabase.h>
 #include <core/RecurringTransaction.h>
 
 class RecurringDialog : public wxDialog {
 public:
-    RecurringDialog(wxWindow* parent, Database* db);
+    RecurringDialog(wxWindow* parent, AsyncDatabase* db);
 
 private:
     void CreateControls();
@@ -30,7 +30,7 @@ private:
     void ShowRecurringDialog(RecurringTransaction* existing = nullptr);
     wxString RecurrenceTypeToString(RecurrenceType type);
 
-    Database* mDatabase;
+    AsyncDatabase* mDatabase;
     wxListCtrl* mRecurringList;
     wxButton* mEditBtn;
     wxButton* mDeleteBtn;
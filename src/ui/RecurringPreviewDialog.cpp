@@ -0,0 +1,46 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#include "RecurringPreviewDialog.h"
+#include <wx/listctrl.h>
+#include "core/Settings.h"
+
+RecurringPreviewDialog::RecurringPreviewDialog(wxWindow* parent, AsyncDatabase* database,
+                                               const std::vector<RecurringOccurrence>& occurrences)
+    : wxDialog(parent, wxID_ANY, "Transactions récurrentes",
+               wxDefaultPosition, wxSize(600, 400)) {
+
+    wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
+
+    wxString message = wxString::Format("%zu transaction(s) récurrente(s) à ajouter, à leur date d'échéance :",
+                                        occurrences.size());
+    mainSizer->Add(new wxStaticText(this, wxID_ANY, message), 0, wxALL, 10);
+
+    wxListCtrl* list = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                      wxLC_REPORT);
+    list->AppendColumn("Date", wxLIST_FORMAT_LEFT, 100);
+    list->AppendColumn("Libellé", wxLIST_FORMAT_LEFT, 250);
+    list->AppendColumn("Montant", wxLIST_FORMAT_RIGHT, 100);
+    list->AppendColumn("Type", wxLIST_FORMAT_LEFT, 100);
+
+    Settings& settings = Settings::GetInstance();
+    for (size_t i = 0; i < occurrences.size(); ++i) {
+        const Transaction& trans = occurrences[i].mTransaction;
+        const bool isDepense = database->IsTypeDepense(trans.GetTypeId());
+
+        long index = list->InsertItem(i, settings.FormatDate(trans.GetDate()));
+        list->SetItem(index, 1, trans.GetLibelle());
+        list->SetItem(index, 2, (isDepense ? "-" : "+") + settings.FormatMoney(trans.GetSomme()));
+        list->SetItem(index, 3, database->GetTypeRegistry().GetName(trans.GetTypeId()));
+    }
+    mainSizer->Add(list, 1, wxLEFT | wxRIGHT | wxEXPAND, 10);
+
+    wxBoxSizer* buttonSizer = new wxBoxSizer(wxHORIZONTAL);
+    buttonSizer->AddStretchSpacer();
+    buttonSizer->Add(new wxButton(this, wxID_CANCEL, "Plus tard"), 0, wxALL, 5);
+    buttonSizer->Add(new wxButton(this, wxID_OK, "Ajouter"), 0, wxALL, 5);
+    mainSizer->Add(buttonSizer, 0, wxALL | wxEXPAND, 10);
+
+    SetSizer(mainSizer);
+}
@@ -0,0 +1,20 @@
+//
+// Created by Jean-Michel Frouin on 17/10/2026.
+//
+
+#ifndef RECURRINGPREVIEWDIALOG_H
+#define RECURRINGPREVIEWDIALOG_H
+
+#include <vector>
+#include <wx/wx.h>
+#include <core/AsyncDatabase.h>
+
+// Aperçu des échéances récurrentes à rattraper : OK les ajoute toutes,
+// Annuler les laisse en attente jusqu'au prochain lancement
+class RecurringPreviewDialog : public wxDialog {
+public:
+    RecurringPreviewDialog(wxWindow* parent, AsyncDatabase* database,
+                           const std::vector<RecurringOccurrence>& occurrences);
+};
+
+#endif // RECURRINGPREVIEWDIALOG_H